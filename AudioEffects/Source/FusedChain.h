@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+    FusedChain.h
+    Created: 18 Oct 2026 10:04:37am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// How one processor handles a single frame (one sample of every channel) inside
+// a FusedChain. There is a specialisation for each processor the apps use.
+template <typename Processor>
+struct FusedStage;
+
+template <typename SampleType>
+struct FusedStage<juce::dsp::Oscillator<SampleType>>
+{
+    static void prepare (juce::dsp::Oscillator<SampleType>& osc, const juce::dsp::ProcessSpec& spec)
+    {
+        osc.prepare (spec);
+    }
+
+    static void reset (juce::dsp::Oscillator<SampleType>& osc) noexcept
+    {
+        osc.reset();
+    }
+
+    // Like Oscillator::process, every channel gets the same value added to it
+    static void processFrame (juce::dsp::Oscillator<SampleType>& osc, SampleType* frame, size_t numChannels) noexcept
+    {
+        auto value = osc.processSample (SampleType (0));
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            frame[channel] += value;
+        }
+    }
+};
+
+template <typename SampleType, typename FunctionType>
+struct FusedStage<juce::dsp::WaveShaper<SampleType, FunctionType>>
+{
+    static void prepare (juce::dsp::WaveShaper<SampleType, FunctionType>& shaper, const juce::dsp::ProcessSpec& spec)
+    {
+        shaper.prepare (spec);
+    }
+
+    static void reset (juce::dsp::WaveShaper<SampleType, FunctionType>& shaper) noexcept
+    {
+        shaper.reset();
+    }
+
+    static void processFrame (juce::dsp::WaveShaper<SampleType, FunctionType>& shaper, SampleType* frame, size_t numChannels) noexcept
+    {
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            frame[channel] = shaper.processSample (frame[channel]);
+        }
+    }
+};
+
+template <typename SampleType>
+struct FusedStage<juce::dsp::LadderFilter<SampleType>>
+{
+    using Filter = juce::dsp::LadderFilter<SampleType>;
+
+    // LadderFilter keeps its per-sample functions protected. A derived class may
+    // take their addresses, and those member pointers work on any LadderFilter.
+    struct Access : Filter
+    {
+        static void callUpdateSmoothers (Filter& filter) noexcept
+        {
+            void (Filter::*method)() = &Access::updateSmoothers;
+            (filter.*method)();
+        }
+
+        static SampleType callProcessSample (Filter& filter, SampleType input, size_t channel) noexcept
+        {
+            SampleType (Filter::*method) (SampleType, size_t) = &Access::processSample;
+            return (filter.*method) (input, channel);
+        }
+    };
+
+    static void prepare (Filter& filter, const juce::dsp::ProcessSpec& spec)
+    {
+        filter.prepare (spec);
+    }
+
+    static void reset (Filter& filter) noexcept
+    {
+        filter.reset();
+    }
+
+    static void processFrame (Filter& filter, SampleType* frame, size_t numChannels) noexcept
+    {
+        if (! filter.isEnabled())
+        {
+            return;
+        }
+
+        Access::callUpdateSmoothers (filter);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            frame[channel] = Access::callProcessSample (filter, frame[channel], channel);
+        }
+    }
+};
+
+template <typename SampleType>
+struct FusedStage<juce::dsp::Gain<SampleType>>
+{
+    static void prepare (juce::dsp::Gain<SampleType>& gain, const juce::dsp::ProcessSpec& spec)
+    {
+        gain.prepare (spec);
+    }
+
+    static void reset (juce::dsp::Gain<SampleType>& gain) noexcept
+    {
+        gain.reset();
+    }
+
+    static void processFrame (juce::dsp::Gain<SampleType>& gain, SampleType* frame, size_t numChannels) noexcept
+    {
+        // processSample advances the smoothed gain, so call it once per frame
+        auto value = gain.processSample (SampleType (1));
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            frame[channel] *= value;
+        }
+    }
+};
+
+template <>
+struct FusedStage<juce::ADSR>
+{
+    static void prepare (juce::ADSR& adsr, const juce::dsp::ProcessSpec& spec)
+    {
+        adsr.setSampleRate (spec.sampleRate);
+    }
+
+    static void reset (juce::ADSR& adsr) noexcept
+    {
+        adsr.reset();
+    }
+
+    static void processFrame (juce::ADSR& adsr, float* frame, size_t numChannels) noexcept
+    {
+        auto value = adsr.getNextSample();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            frame[channel] *= value;
+        }
+    }
+};
+
+// A drop-in replacement for juce::dsp::ProcessorChain that runs every processor
+// on one sample before moving on to the next, instead of running each processor
+// over the whole block in turn. The block is read and written once however many
+// processors there are. A juce::ADSR can be the last stage to apply the envelope.
+template <typename... Processors>
+class FusedChain
+{
+public:
+    template <int Index>
+    auto& get() noexcept
+    {
+        return std::get<Index> (processors);
+    }
+
+    template <int Index>
+    const auto& get() const noexcept
+    {
+        return std::get<Index> (processors);
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert (spec.numChannels <= (juce::uint32) maxChannels);
+        prepareStage (spec, std::integral_constant<size_t, 0>());
+    }
+
+    void reset() noexcept
+    {
+        resetStage (std::integral_constant<size_t, 0>());
+    }
+
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& inputBlock = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+            {
+                outputBlock.copyFrom (inputBlock);
+            }
+            return;
+        }
+
+        render (inputBlock, outputBlock, false);
+    }
+
+    // Renders from silence and adds the result to outputBlock, so a voice can
+    // mix straight into a shared buffer without a scratch buffer
+    void processAdding (const juce::dsp::AudioBlock<float>& outputBlock) noexcept
+    {
+        render (outputBlock, outputBlock, true);
+    }
+
+private:
+    static constexpr size_t maxChannels = 8;
+
+    template <typename InputBlock, typename OutputBlock>
+    void render (const InputBlock& inputBlock, const OutputBlock& outputBlock, bool isAdding) noexcept
+    {
+        auto numChannels = juce::jmin (outputBlock.getNumChannels(), maxChannels);
+        auto numInputChannels = isAdding ? 0 : juce::jmin (inputBlock.getNumChannels(), numChannels);
+        auto numSamples = outputBlock.getNumSamples();
+
+        const float* inputs[maxChannels];
+        float* outputs[maxChannels];
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            inputs[channel] = channel < numInputChannels ? inputBlock.getChannelPointer (channel) : nullptr;
+            outputs[channel] = outputBlock.getChannelPointer (channel);
+        }
+
+        float frame[maxChannels];
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                frame[channel] = inputs[channel] != nullptr ? inputs[channel][sample] : 0.0f;
+            }
+
+            processStage (frame, numChannels, std::integral_constant<size_t, 0>());
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                outputs[channel][sample] = isAdding ? outputs[channel][sample] + frame[channel] : frame[channel];
+            }
+        }
+    }
+
+    // Each of these walks the tuple at compile time. The overload that takes
+    // the end index stops the recursion.
+    template <size_t Index>
+    void prepareStage (const juce::dsp::ProcessSpec& spec, std::integral_constant<size_t, Index>)
+    {
+        FusedStage<typename std::tuple_element<Index, std::tuple<Processors...>>::type>::prepare (std::get<Index> (processors), spec);
+        prepareStage (spec, std::integral_constant<size_t, Index + 1>());
+    }
+
+    void prepareStage (const juce::dsp::ProcessSpec&, std::integral_constant<size_t, sizeof... (Processors)>) {}
+
+    template <size_t Index>
+    void resetStage (std::integral_constant<size_t, Index>) noexcept
+    {
+        FusedStage<typename std::tuple_element<Index, std::tuple<Processors...>>::type>::reset (std::get<Index> (processors));
+        resetStage (std::integral_constant<size_t, Index + 1>());
+    }
+
+    void resetStage (std::integral_constant<size_t, sizeof... (Processors)>) noexcept {}
+
+    template <size_t Index>
+    void processStage (float* frame, size_t numChannels, std::integral_constant<size_t, Index>) noexcept
+    {
+        FusedStage<typename std::tuple_element<Index, std::tuple<Processors...>>::type>::processFrame (std::get<Index> (processors), frame, numChannels);
+        processStage (frame, numChannels, std::integral_constant<size_t, Index + 1>());
+    }
+
+    void processStage (float*, size_t, std::integral_constant<size_t, sizeof... (Processors)>) noexcept {}
+
+    std::tuple<Processors...> processors;
+};
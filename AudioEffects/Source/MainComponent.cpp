@@ -92,8 +92,8 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     
     processorChain.get<filterIndex>().setMode (juce::dsp::LadderFilterMode::LPF24);
     
-    adsr.setSampleRate (sampleRate);
-    adsr.reset();
+    // prepare() has already given the envelope its sample rate
+    processorChain.get<envelopeIndex>().reset();
     
     for (int i = 0; i < panels.size(); ++i)
     {
@@ -103,6 +103,8 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    AudioThreadGuard guard;
+
     Parameters::curClip = panels[Parameters::distortionIndex]->getNextValue (Parameters::clipIndex);
     
     processorChain.get<filterIndex>().setResonance (panels[Parameters::lpfIndex]->getNextValue (Parameters::resonanceIndex));
@@ -118,6 +120,7 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     reverb.setParameters (revParam);
     
     // Set adsr parameters
+    auto& adsr = processorChain.get<envelopeIndex>();
     auto adsrParam = adsr.getParameters();
     adsrParam.attack = panels[Parameters::adsrIndex]->getNextValue (Parameters::attackIndex);
     adsrParam.decay = panels[Parameters::adsrIndex]->getNextValue (Parameters::decayIndex);
@@ -125,12 +128,13 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     adsrParam.release = panels[Parameters::adsrIndex]->getNextValue (Parameters::releaseIndex);
     adsr.setParameters (adsrParam);
     
-    // Process audio
-    juce::AudioBuffer<float> buffer = *bufferToFill.buffer;
-    juce::dsp::AudioBlock<float> block (buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
+    // Process audio in place, straight into the device buffer. The oscillator adds
+    // to what is already there, so clear out any microphone input first.
+    bufferToFill.clearActiveBufferRegion();
+    juce::dsp::AudioBlock<float> block (*bufferToFill.buffer);
+    auto subBlock = block.getSubBlock ((size_t) bufferToFill.startSample, (size_t) bufferToFill.numSamples);
+    juce::dsp::ProcessContextReplacing<float> context (subBlock);
     processorChain.process (context);
-    adsr.applyEnvelopeToBuffer (buffer, 0, buffer.getNumSamples());
     reverb.process (context);
 }
 
@@ -178,10 +182,10 @@ void MainComponent::handleNoteOn (juce::MidiKeyboardState *source, int midiChann
 {
     processorChain.get<oscIndex>().setFrequency (juce::MidiMessage::getMidiNoteInHertz (midiNoteNumber));
     processorChain.get<gainIndex>().setGainLinear (velocity * panels[Parameters::gainIndex]->getNextValue (Parameters::levelIndex));
-    adsr.noteOn();
+    processorChain.get<envelopeIndex>().noteOn();
 }
 
 void MainComponent::handleNoteOff (juce::MidiKeyboardState *source, int midiChannel, int midiNoteNumber, float velocity)
 {
-    adsr.noteOff();
+    processorChain.get<envelopeIndex>().noteOff();
 }
@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 #include "SliderPanel.h"
+#include "AudioThreadGuard.h"
+#include "FusedChain.h"
 
 //==============================================================================
 /*
@@ -33,12 +35,13 @@ private:
         oscIndex,
         shaperIndex,
         filterIndex,
-        gainIndex
+        gainIndex,
+        envelopeIndex
     };
     
-    juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::WaveShaper<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>> processorChain;
+    // The envelope runs as the last stage of the chain so the voice is rendered in a single pass
+    FusedChain<juce::dsp::Oscillator<float>, juce::dsp::WaveShaper<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>, juce::ADSR> processorChain;
     juce::dsp::Reverb reverb;
-    juce::ADSR adsr;
     
     juce::MidiKeyboardState keyboardState;
     juce::MidiKeyboardComponent keyboardComponent;
@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    AudioThreadGuard.cpp
+    Created: 17 Oct 2026 4:40:12pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "AudioThreadGuard.h"
+
+#if JUCE_DEBUG && (JUCE_MAC || JUCE_IOS)
+ #include <malloc/malloc.h>
+ #include <mach/mach.h>
+#endif
+
+#if JUCE_DEBUG
+
+namespace
+{
+    // Plain atomics rather than thread_local, because thread-local storage can be
+    // allocated on first use, which would land straight back in the hooks below.
+    // guardDepth and isReporting are only touched by the guarded thread.
+    std::atomic<juce::Thread::ThreadID> guardedThread { nullptr };
+    int guardDepth = 0;
+    bool isReporting = false;
+}
+
+AudioThreadGuard::AudioThreadGuard() noexcept
+{
+    auto thisThread = juce::Thread::getCurrentThreadId();
+
+    // One thread is guarded at a time, which is all an app with one audio callback needs
+    jassert (guardedThread.load() == nullptr || guardedThread.load() == thisThread);
+
+    guardedThread = thisThread;
+    ++guardDepth;
+}
+
+AudioThreadGuard::~AudioThreadGuard() noexcept
+{
+    if (--guardDepth == 0)
+    {
+        guardedThread = nullptr;
+    }
+}
+
+void AudioThreadGuard::checkAllocation() noexcept
+{
+    // Logging the assertion allocates too, so ignore anything it does itself
+    if (guardedThread.load (std::memory_order_relaxed) == juce::Thread::getCurrentThreadId() && ! isReporting)
+    {
+        isReporting = true;
+
+        // Something on the audio thread allocated or freed memory. Check the call stack.
+        jassertfalse;
+
+        isReporting = false;
+    }
+}
+
+#else
+
+AudioThreadGuard::AudioThreadGuard() noexcept {}
+AudioThreadGuard::~AudioThreadGuard() noexcept {}
+void AudioThreadGuard::checkAllocation() noexcept {}
+
+#endif
+
+#if AUDIOTHREADGUARD_WRAP_MALLOC
+
+// The Android exporter links with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free,
+// so every call to these in the app and the static C++ library, operator new included,
+// comes here first. In release builds they only pass the call on.
+extern "C"
+{
+    void* __real_malloc (size_t size);
+    void* __real_calloc (size_t num, size_t size);
+    void* __real_realloc (void* memory, size_t size);
+    void __real_free (void* memory);
+
+    void* __wrap_malloc (size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return __real_malloc (size);
+    }
+
+    void* __wrap_calloc (size_t num, size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return __real_calloc (num, size);
+    }
+
+    void* __wrap_realloc (void* memory, size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return __real_realloc (memory, size);
+    }
+
+    void __wrap_free (void* memory)
+    {
+        if (memory != nullptr)
+        {
+            AudioThreadGuard::checkAllocation();
+        }
+
+        __real_free (memory);
+    }
+}
+
+#elif JUCE_DEBUG && (JUCE_MAC || JUCE_IOS)
+
+namespace
+{
+    // The functions each malloc zone had before it was hooked
+    struct HookedZone
+    {
+        malloc_zone_t* zone;
+        decltype (malloc_zone_t::malloc) malloc;
+        decltype (malloc_zone_t::calloc) calloc;
+        decltype (malloc_zone_t::realloc) realloc;
+        decltype (malloc_zone_t::free) free;
+    };
+
+    constexpr int maxHookedZones = 8;
+    HookedZone hookedZones[maxHookedZones];
+    int numHookedZones = 0;
+
+    const HookedZone& getHookedZone (malloc_zone_t* zone)
+    {
+        for (auto i = 0; i < numHookedZones; ++i)
+        {
+            if (hookedZones[i].zone == zone)
+            {
+                return hookedZones[i];
+            }
+        }
+
+        jassertfalse;
+        return hookedZones[0];
+    }
+
+    void* guardedMalloc (malloc_zone_t* zone, size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return getHookedZone (zone).malloc (zone, size);
+    }
+
+    void* guardedCalloc (malloc_zone_t* zone, size_t num, size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return getHookedZone (zone).calloc (zone, num, size);
+    }
+
+    void* guardedRealloc (malloc_zone_t* zone, void* memory, size_t size)
+    {
+        AudioThreadGuard::checkAllocation();
+        return getHookedZone (zone).realloc (zone, memory, size);
+    }
+
+    void guardedFree (malloc_zone_t* zone, void* memory)
+    {
+        if (memory != nullptr)
+        {
+            AudioThreadGuard::checkAllocation();
+        }
+
+        getHookedZone (zone).free (zone, memory);
+    }
+
+    // malloc and free on Apple platforms go through the registered malloc zones, so
+    // swapping the zones' functions catches them without any linker options. This
+    // runs during static initialisation, before any audio starts.
+    struct ZoneHooks
+    {
+        ZoneHooks()
+        {
+            vm_address_t* zones = nullptr;
+            unsigned int numZones = 0;
+
+            if (malloc_get_all_zones (mach_task_self(), nullptr, &zones, &numZones) != KERN_SUCCESS)
+            {
+                return;
+            }
+
+            for (auto i = 0u; i < numZones && numHookedZones < maxHookedZones; ++i)
+            {
+                auto* zone = reinterpret_cast<malloc_zone_t*> (zones[i]);
+                hookedZones[numHookedZones++] = { zone, zone->malloc, zone->calloc, zone->realloc, zone->free };
+
+                // Newer zones are kept read-only
+                auto isReadOnly = zone->version >= 8;
+                if (isReadOnly)
+                {
+                    vm_protect (mach_task_self(), (vm_address_t) zone, sizeof (malloc_zone_t), 0, VM_PROT_READ | VM_PROT_WRITE);
+                }
+
+                zone->malloc = guardedMalloc;
+                zone->calloc = guardedCalloc;
+                zone->realloc = guardedRealloc;
+                zone->free = guardedFree;
+
+                if (isReadOnly)
+                {
+                    vm_protect (mach_task_self(), (vm_address_t) zone, sizeof (malloc_zone_t), 0, VM_PROT_READ);
+                }
+            }
+        }
+    };
+
+    ZoneHooks zoneHooks;
+}
+
+#elif JUCE_DEBUG
+
+// Without malloc hooks, replacing these still catches every new and delete in the app, JUCE included
+void* operator new (std::size_t size)
+{
+    AudioThreadGuard::checkAllocation();
+
+    if (auto* memory = std::malloc (size > 0 ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void operator delete (void* memory) noexcept
+{
+    if (memory != nullptr)
+    {
+        AudioThreadGuard::checkAllocation();
+    }
+
+    std::free (memory);
+}
+
+void operator delete[] (void* memory) noexcept
+{
+    operator delete (memory);
+}
+
+void operator delete (void* memory, std::size_t) noexcept
+{
+    operator delete (memory);
+}
+
+void operator delete[] (void* memory, std::size_t) noexcept
+{
+    operator delete (memory);
+}
+
+#endif
@@ -89,27 +89,22 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlockExpected;
     spec.numChannels = 2;
-    processorChain.prepare (spec);
-    
-    generateSine();
 
-    processorChain.get<oscIndex>().setFrequency (440, true);
-    processorChain.get<gainIndex>().setGainLinear (0.5f);
+    // All the voices are allocated here so playing notes never allocates
+    voicePool.prepare (spec, numVoices);
 
-    // Initialize ADSR
-    adsr.setSampleRate(sampleRate);
-    adsr.reset();
+   #if CLASSROOMSYNTH_BENCHMARK
+    for (auto voices : { numVoices, numVoices * 2 })
+    {
+        juce::Logger::writeToLog (OscillatorBank::runBenchmark (sampleRate, voices, samplesPerBlockExpected, 2000));
+    }
+   #endif
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    juce::AudioBuffer<float> buffer = *bufferToFill.buffer;
-    juce::dsp::AudioBlock<float> block (buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
-    processorChain.process (context);
-
-    // Apply ADSR
-    adsr.applyEnvelopeToBuffer (buffer, 0, buffer.getNumSamples());
+    AudioThreadGuard guard;
+    voicePool.renderNextBlock (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
 }
 
 void MainComponent::releaseResources()
@@ -158,14 +153,12 @@ void MainComponent::resized()
 //==============================================================================
 void MainComponent::handleNoteOn (juce::MidiKeyboardState *source, int midiChannel, int midiNoteNumber, float velocity)
 {
-    processorChain.get<oscIndex>().setFrequency (juce::MidiMessage::getMidiNoteInHertz (midiNoteNumber));
-    processorChain.get<gainIndex>().setGainLinear (velocity);
-    adsr.noteOn();
+    voicePool.noteOn (midiNoteNumber, velocity);
 }
 
 void MainComponent::handleNoteOff (juce::MidiKeyboardState *source, int midiChannel, int midiNoteNumber, float velocity)
 {
-    adsr.noteOff();
+    voicePool.noteOff (midiNoteNumber);
 }
 
 juce::Image MainComponent::loadImage (juce::String fileName)
@@ -190,7 +183,7 @@ juce::Image MainComponent::loadImage (juce::String fileName)
 
 void MainComponent::sliderValueChanged (juce::Slider *slider)
 {
-    auto parameters = adsr.getParameters();
+    auto parameters = voicePool.getParameters();
     auto parameter = slider->getValue();
 
     if (slider == sliders[0])
@@ -202,7 +195,7 @@ void MainComponent::sliderValueChanged (juce::Slider *slider)
     else
         parameters.release = parameter;
 
-    adsr.setParameters (parameters);
+    voicePool.setParameters (parameters);
 }
 
 void MainComponent::buttonClicked (juce::Button* button)
@@ -216,68 +209,22 @@ void MainComponent::buttonClicked (juce::Button* button)
     // Generate waveform and turn on the button based on the user's choice
     if (button == buttons[0])
     {
-        generateSine();
+        voicePool.setWaveform (Wavetable::Waveform::sine);
         buttons[0]->setToggleState (true, juce::dontSendNotification);
     }
     else if (button == buttons[1])
     {
-        generateSawtooth();
+        voicePool.setWaveform (Wavetable::Waveform::sawtooth);
         buttons[1]->setToggleState (true, juce::dontSendNotification);
     }
     else if (button == buttons[2])
     {
-        generateSquare();
+        voicePool.setWaveform (Wavetable::Waveform::square);
         buttons[2]->setToggleState (true, juce::dontSendNotification);
     }
     else
     {
-        generateTriangle();
+        voicePool.setWaveform (Wavetable::Waveform::triangle);
         buttons[3]->setToggleState (true, juce::dontSendNotification);
     }
 }
-
-void MainComponent::generateSine()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-                    {
-                        return std::sin (x);
-                    }, 128);
-}
-
-void MainComponent::generateSawtooth()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-                    {
-                        return juce::jmap (x,
-                                           float (-juce::MathConstants<float>::pi),
-                                           float (juce::MathConstants<float>::pi),
-                                           float (-1),
-                                           float (1));
-                    }, 2);
-}
-
-void MainComponent::generateSquare()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-                    {
-                        auto val = std::sin (x);
-                        return (0.0f < val) - (val < 0.0f);
-                    }, 128);
-}
-
-void MainComponent::generateTriangle()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-                    {
-                        auto val = juce::jmap (x,
-                                               float (-juce::MathConstants<float>::pi),
-                                               float (juce::MathConstants<float>::pi),
-                                               float (0),
-                                               float (1));
-                        return 2.0f * std::fabs (2.0f * (val - std::floor (val + 0.5f))) - 1.0f;
-                    }, 128);
-}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "VoicePool.h"
+#include "AudioThreadGuard.h"
 
 //==============================================================================
 /*
@@ -33,29 +35,18 @@ public:
 
 private:
     //==============================================================================
-    juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::Gain<float>> processorChain;
-
-    enum
-    {
-        oscIndex,
-        gainIndex
-    };
+    static constexpr int numVoices = 16;
+    VoicePool voicePool;
 
     // Keyboard
     juce::MidiKeyboardState keyboardState;
     juce::MidiKeyboardComponent keyboardComponent;
-    juce::ADSR adsr;
 
     // Sliders and buttons
     juce::OwnedArray<juce::Slider> sliders;
     juce::OwnedArray<juce::DrawableButton> buttons;
 
     juce::Image loadImage (juce::String fileName);
-    
-    void generateSine();
-    void generateSawtooth();
-    void generateSquare();
-    void generateTriangle();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
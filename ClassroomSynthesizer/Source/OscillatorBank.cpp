@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    OscillatorBank.cpp
+    Created: 17 Oct 2026 3:32:10pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "OscillatorBank.h"
+#include "WavetableOscillator.h"
+
+void OscillatorBank::prepare (const WavetableBank& wavetableBank, double sampleRate, int numVoices, int maximumBlockSize)
+{
+    bank = &wavetableBank;
+    this->sampleRate = sampleRate;
+    this->maximumBlockSize = maximumBlockSize;
+
+    // Round up to whole SIMD registers. The spare lanes stay silent.
+    numLanes = (numVoices + numSIMDLanes - 1) / numSIMDLanes * numSIMDLanes;
+
+    phases = allocateAligned (phaseBlock, numLanes);
+    increments = allocateAligned (incrementBlock, numLanes);
+    octaveFades = allocateAligned (octaveFadeBlock, numLanes);
+    waveFades = allocateAligned (waveFadeBlock, numLanes);
+    envelopes = allocateAligned (envelopeBlock, numLanes * maximumBlockSize);
+
+    positions = allocateAligned (scratchBlock, numSIMDLanes * 6);
+    fractions = positions + numSIMDLanes;
+    lowSamples = fractions + numSIMDLanes;
+    lowNextSamples = lowSamples + numSIMDLanes;
+    highSamples = lowNextSamples + numSIMDLanes;
+    highNextSamples = highSamples + numSIMDLanes;
+
+    currentTables.calloc ((size_t) numLanes);
+    previousTables.calloc ((size_t) numLanes);
+    waveforms.calloc ((size_t) numLanes);
+    laneActive.calloc ((size_t) numLanes);
+
+    fadeStep = 1.0f / (float) juce::jmax (1, juce::roundToInt (sampleRate * 0.01));
+
+    // Every lane points at valid tables, even the ones no voice uses,
+    // so render() never has to check for them
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        waveforms[lane] = Wavetable::Waveform::sine;
+        startVoice (lane, Wavetable::minFrequency, Wavetable::Waveform::sine);
+    }
+}
+
+void OscillatorBank::startVoice (int lane, float frequency, Wavetable::Waveform waveform) noexcept
+{
+    auto& wavetable = bank->get (waveform);
+    auto position = wavetable.getTablePosition (frequency);
+    auto index = (int) position;
+
+    // Fade out whatever the lane was playing instead of switching tables under it
+    if (laneActive[lane] && waveform != waveforms[lane])
+    {
+        previousTables[lane] = getTables (waveforms[lane], index);
+        waveFades[lane] = 1.0f;
+    }
+    else
+    {
+        waveFades[lane] = 0.0f;
+    }
+
+    currentTables[lane] = getTables (waveform, index);
+    waveforms[lane] = waveform;
+    octaveFades[lane] = position - (float) index;
+    increments[lane] = (float) (frequency / sampleRate);
+}
+
+void OscillatorBank::setWaveform (int lane, Wavetable::Waveform waveform) noexcept
+{
+    // startVoice leaves the phase alone, so restarting at the same frequency only swaps the tables
+    startVoice (lane, increments[lane] * (float) sampleRate, waveform);
+}
+
+void OscillatorBank::render (float* output, int numSamples) noexcept
+{
+    jassert (numSamples <= maximumBlockSize);
+
+    auto one = SIMDFloat::expand (1.0f);
+    auto zero = SIMDFloat::expand (0.0f);
+    auto step = SIMDFloat::expand (fadeStep);
+
+    for (int firstLane = 0; firstLane < numLanes; firstLane += numSIMDLanes)
+    {
+        // A register with no sounding voice is skipped entirely
+        if (! isGroupActive (firstLane))
+        {
+            continue;
+        }
+
+        auto phase = SIMDFloat::fromRawArray (phases + firstLane);
+        auto increment = SIMDFloat::fromRawArray (increments + firstLane);
+        auto octaveFade = SIMDFloat::fromRawArray (octaveFades + firstLane);
+        auto waveFade = SIMDFloat::fromRawArray (waveFades + firstLane);
+        auto isFading = isGroupFading (firstLane);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            auto value = readTables (currentTables, firstLane, phase, octaveFade);
+
+            if (isFading)
+            {
+                auto previousValue = readTables (previousTables, firstLane, phase, octaveFade);
+                value = value + waveFade * (previousValue - value);
+                waveFade = SIMDFloat::max (zero, waveFade - step);
+            }
+
+            value = value * SIMDFloat::fromRawArray (envelopes + sample * numLanes + firstLane);
+            output[sample] += value.sum();
+
+            phase = phase + increment;
+            phase = phase - (one & SIMDFloat::greaterThanOrEqual (phase, one));
+        }
+
+        phase.copyToRawArray (phases + firstLane);
+        waveFade.copyToRawArray (waveFades + firstLane);
+    }
+}
+
+juce::String OscillatorBank::runBenchmark (double sampleRate, int numVoices, int blockSize, int numBlocks)
+{
+    WavetableBank wavetableBank;
+    wavetableBank.build (sampleRate);
+
+    juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, 1 };
+    juce::OwnedArray<WavetableOscillator> oscillators;
+    OscillatorBank oscillatorBank;
+    oscillatorBank.prepare (wavetableBank, sampleRate, numVoices, blockSize);
+
+    // Spread the voices over a few octaves and all the waveforms
+    for (int voice = 0; voice < numVoices; ++voice)
+    {
+        auto frequency = (float) juce::MidiMessage::getMidiNoteInHertz (36 + voice * 3);
+        auto waveform = (Wavetable::Waveform) (voice % WavetableBank::numWaveforms);
+
+        auto* osc = oscillators.add (new WavetableOscillator());
+        osc->setWavetableBank (wavetableBank);
+        osc->setWaveform (waveform);
+        osc->prepare (spec);
+        osc->setFrequency (frequency, true);
+
+        oscillatorBank.startVoice (voice, frequency, waveform);
+        oscillatorBank.setLaneActive (voice, true);
+    }
+
+    juce::AudioBuffer<float> output (1, blockSize);
+    auto* channelData = output.getWritePointer (0);
+    auto gain = 1.0f / (float) numVoices;
+
+    // One oscillator after another, the way the voices used to render
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        output.clear();
+        for (auto* osc : oscillators)
+        {
+            for (int sample = 0; sample < blockSize; ++sample)
+            {
+                channelData[sample] += osc->processSample() * gain;
+            }
+        }
+    }
+    auto perVoiceTime = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    startTime = juce::Time::getMillisecondCounterHiRes();
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        output.clear();
+        auto* envelope = oscillatorBank.getEnvelopes();
+        for (int sample = 0; sample < blockSize; ++sample)
+        {
+            for (int voice = 0; voice < numVoices; ++voice)
+            {
+                envelope[sample * oscillatorBank.getEnvelopeStride() + voice] = gain;
+            }
+        }
+        oscillatorBank.render (channelData, blockSize);
+    }
+    auto bankTime = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    return "OscillatorBank: " + juce::String (numVoices) + " voices, "
+           + juce::String (numBlocks) + " blocks of " + juce::String (blockSize) + " samples, "
+           + "per voice " + juce::String (perVoiceTime, 2) + " ms, "
+           + juce::String (numSIMDLanes) + "-wide bank " + juce::String (bankTime, 2) + " ms ("
+           + juce::String (perVoiceTime / juce::jmax (bankTime, 0.001), 2) + "x)";
+}
+
+float* OscillatorBank::allocateAligned (juce::HeapBlock<float>& block, int size)
+{
+    // Over-allocate by one register so the start can be moved up to an aligned address
+    block.calloc ((size_t) (size + numSIMDLanes));
+    return SIMDFloat::getNextSIMDAlignedPtr (block.get());
+}
+
+OscillatorBank::OctaveTables OscillatorBank::getTables (Wavetable::Waveform waveform, int index) const noexcept
+{
+    auto& wavetable = bank->get (waveform);
+
+    // The top table has nothing above it, but its crossfade amount is always 0 there
+    return { wavetable.getTable (index), wavetable.getTable (juce::jmin (index + 1, wavetable.getNumTables() - 1)) };
+}
+
+OscillatorBank::SIMDFloat OscillatorBank::readTables (const OctaveTables* tables, int firstLane,
+                                                       SIMDFloat phase, SIMDFloat octaveFade) noexcept
+{
+    (phase * SIMDFloat::expand ((float) Wavetable::tableSize)).copyToRawArray (positions);
+
+    for (int i = 0; i < numSIMDLanes; ++i)
+    {
+        auto& lane = tables[firstLane + i];
+        auto index = (int) positions[i];
+
+        fractions[i] = positions[i] - (float) index;
+        index &= Wavetable::tableSize - 1;
+
+        lowSamples[i] = lane.low[index];
+        lowNextSamples[i] = lane.low[index + 1];
+        highSamples[i] = lane.high[index];
+        highNextSamples[i] = lane.high[index + 1];
+    }
+
+    auto fraction = SIMDFloat::fromRawArray (fractions);
+    auto low = SIMDFloat::fromRawArray (lowSamples);
+    auto high = SIMDFloat::fromRawArray (highSamples);
+
+    low = low + fraction * (SIMDFloat::fromRawArray (lowNextSamples) - low);
+    high = high + fraction * (SIMDFloat::fromRawArray (highNextSamples) - high);
+
+    return low + octaveFade * (high - low);
+}
+
+bool OscillatorBank::isGroupActive (int firstLane) const noexcept
+{
+    for (int i = firstLane; i < firstLane + numSIMDLanes; ++i)
+    {
+        if (laneActive[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool OscillatorBank::isGroupFading (int firstLane) const noexcept
+{
+    for (int i = firstLane; i < firstLane + numSIMDLanes; ++i)
+    {
+        if (waveFades[i] > 0.0f)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    OscillatorBank.h
+    Created: 17 Oct 2026 3:32:10pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Wavetable.h"
+
+// Set this to 1 in the Projucer preprocessor definitions to log a comparison
+// of the bank against one WavetableOscillator per voice in prepareToPlay
+#ifndef CLASSROOMSYNTH_BENCHMARK
+ #define CLASSROOMSYNTH_BENCHMARK 0
+#endif
+
+// The wavetable oscillators of all the voices, stored as structure-of-arrays so
+// one juce::dsp::SIMDRegister runs 4 (SSE/NEON) or 8 (AVX) voices at once.
+// Lane n belongs to voice n. Voices write their envelopes into an interleaved
+// buffer and render() mixes every active lane down to a single channel.
+class OscillatorBank
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr int numSIMDLanes = (int) SIMDFloat::SIMDNumElements;
+
+    // Allocates everything, so call it from prepareToPlay
+    void prepare (const WavetableBank& wavetableBank, double sampleRate, int numVoices, int maximumBlockSize);
+
+    // Audio thread only. A lane that is still sounding crossfades to the new waveform.
+    void startVoice (int lane, float frequency, Wavetable::Waveform waveform) noexcept;
+
+    // Audio thread only. Switches the waveform of a lane without touching its pitch or phase.
+    void setWaveform (int lane, Wavetable::Waveform waveform) noexcept;
+
+    void setLaneActive (int lane, bool isActive) noexcept
+    {
+        laneActive[lane] = isActive;
+    }
+
+    int getMaximumBlockSize() const noexcept
+    {
+        return maximumBlockSize;
+    }
+
+    // Envelope gains laid out as [sample * getEnvelopeStride() + lane].
+    // Clear them, let each voice fill its lane, then call render().
+    float* getEnvelopes() noexcept
+    {
+        return envelopes;
+    }
+
+    int getEnvelopeStride() const noexcept
+    {
+        return numLanes;
+    }
+
+    void clearEnvelopes (int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::clear (envelopes, numSamples * numLanes);
+    }
+
+    // Adds the enveloped oscillators of all active lanes to output.
+    // numSamples must not be more than getMaximumBlockSize().
+    void render (float* output, int numSamples) noexcept;
+
+    // Renders the same voices through the bank and through one WavetableOscillator
+    // per voice and returns the timings. This allocates, so never call it while playing.
+    static juce::String runBenchmark (double sampleRate, int numVoices, int blockSize, int numBlocks);
+
+private:
+    // Per-lane table pointers for the octave below and above the playing frequency
+    struct OctaveTables
+    {
+        const float* low;
+        const float* high;
+    };
+
+    static float* allocateAligned (juce::HeapBlock<float>& block, int size);
+    OctaveTables getTables (Wavetable::Waveform waveform, int index) const noexcept;
+    SIMDFloat readTables (const OctaveTables* tables, int firstLane, SIMDFloat phase, SIMDFloat octaveFade) noexcept;
+    bool isGroupActive (int firstLane) const noexcept;
+    bool isGroupFading (int firstLane) const noexcept;
+
+    const WavetableBank* bank = nullptr;
+    double sampleRate = 44100.0;
+    int numLanes = 0;
+    int maximumBlockSize = 0;
+    float fadeStep = 1.0f;
+
+    // Per-lane state, SIMD aligned so whole groups load straight into registers
+    juce::HeapBlock<float> phaseBlock, incrementBlock, octaveFadeBlock, waveFadeBlock, envelopeBlock, scratchBlock;
+    float* phases = nullptr;
+    float* increments = nullptr;
+    float* octaveFades = nullptr;
+    float* waveFades = nullptr;
+    float* envelopes = nullptr;
+
+    // Table reads can't be vectorised, so each lane is read into here first
+    float* positions = nullptr;
+    float* fractions = nullptr;
+    float* lowSamples = nullptr;
+    float* lowNextSamples = nullptr;
+    float* highSamples = nullptr;
+    float* highNextSamples = nullptr;
+
+    juce::HeapBlock<OctaveTables> currentTables, previousTables;
+    juce::HeapBlock<Wavetable::Waveform> waveforms;
+    juce::HeapBlock<bool> laneActive;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OscillatorBank)
+};
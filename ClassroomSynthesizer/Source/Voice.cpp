@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    Voice.cpp
+    Created: 17 Oct 2026 1:05:22pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "Voice.h"
+
+void Voice::prepare (double sampleRate)
+{
+    adsr.setSampleRate (sampleRate);
+    adsr.reset();
+
+    noteNumber = -1;
+    level = 0.0f;
+    isReleasing = false;
+}
+
+void Voice::start (int midiNoteNumber, float velocity, juce::uint32 noteOrder)
+{
+    noteNumber = midiNoteNumber;
+    gain = velocity;
+    isReleasing = false;
+    this->noteOrder = noteOrder;
+
+    // The envelope carries on from its current level, so stealing a sounding voice doesn't click
+    adsr.noteOn();
+}
+
+void Voice::stop()
+{
+    isReleasing = true;
+    adsr.noteOff();
+}
+
+void Voice::renderEnvelope (float* envelope, int stride, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        level = adsr.getNextSample();
+        envelope[sample * stride] = level * gain;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    Voice.h
+    Created: 17 Oct 2026 1:05:22pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "OscillatorBank.h"
+
+// A single note of the synthesizer. The voice only runs the ADSR; its oscillator
+// is the lane with the same index in the VoicePool's OscillatorBank.
+// Voices are created up front by the VoicePool and reused for every note.
+class Voice
+{
+public:
+    void prepare (double sampleRate);
+
+    void start (int midiNoteNumber, float velocity, juce::uint32 noteOrder);
+    void stop();
+
+    // Writes the envelope gain of each sample, stride floats apart
+    void renderEnvelope (float* envelope, int stride, int numSamples);
+
+    void setParameters (const juce::ADSR::Parameters& parameters)
+    {
+        adsr.setParameters (parameters);
+    }
+
+    bool isActive() const
+    {
+        return adsr.isActive();
+    }
+
+    bool getIsReleasing() const
+    {
+        return isReleasing;
+    }
+
+    int getNoteNumber() const
+    {
+        return noteNumber;
+    }
+
+    float getLevel() const
+    {
+        return level;
+    }
+
+    juce::uint32 getNoteOrder() const
+    {
+        return noteOrder;
+    }
+
+private:
+    juce::ADSR adsr;
+
+    int noteNumber = -1;
+    float gain = 0.0f;
+    float level = 0.0f;
+    bool isReleasing = false;
+    juce::uint32 noteOrder = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Voice)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    VoicePool.cpp
+    Created: 17 Oct 2026 1:18:47pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "VoicePool.h"
+
+void VoicePool::prepare (const juce::dsp::ProcessSpec& spec, int numVoices)
+{
+    // The tables are shared by every voice, so build them once before the oscillators point at them
+    bank.build (spec.sampleRate);
+    oscillators.prepare (bank, spec.sampleRate, numVoices, (int) spec.maximumBlockSize);
+
+    voices.clear();
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices.add (new Voice());
+        voices[i]->prepare (spec.sampleRate);
+    }
+
+    fifo.reset();
+    currentWaveform = waveform.get();
+    parametersChanged = true;
+}
+
+void VoicePool::renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (parametersChanged.exchange (false))
+    {
+        juce::ADSR::Parameters parameters { attack.get(), decay.get(), sustain.get(), release.get() };
+        for (auto* voice : voices)
+        {
+            voice->setParameters (parameters);
+        }
+    }
+
+    // Sounding voices crossfade to a new waveform instead of waiting for their next note
+    if (waveform.get() != currentWaveform)
+    {
+        currentWaveform = waveform.get();
+        for (int i = 0; i < voices.size(); ++i)
+        {
+            if (voices.getUnchecked (i)->isActive())
+            {
+                oscillators.setWaveform (i, currentWaveform);
+            }
+        }
+    }
+
+    // Apply the notes that arrived since the last block
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+    for (int i = 0; i < size1; ++i)
+    {
+        handleEvent (events[start1 + i]);
+    }
+    for (int i = 0; i < size2; ++i)
+    {
+        handleEvent (events[start2 + i]);
+    }
+    fifo.finishedRead (size1 + size2);
+
+    outputBuffer.clear (startSample, numSamples);
+
+    // The bank's envelope buffer is sized for the expected block size, so longer blocks are split
+    auto* channelDataOut = outputBuffer.getWritePointer (0, startSample);
+    for (int offset = 0; offset < numSamples; offset += oscillators.getMaximumBlockSize())
+    {
+        renderVoices (channelDataOut + offset, juce::jmin (oscillators.getMaximumBlockSize(), numSamples - offset));
+    }
+
+    // Voices are mono, so copy the mix to the other channels
+    outputBuffer.applyGain (0, startSample, numSamples, masterGain);
+    for (int channel = 1; channel < outputBuffer.getNumChannels(); ++channel)
+    {
+        outputBuffer.copyFrom (channel, startSample, outputBuffer, 0, startSample, numSamples);
+    }
+}
+
+// Message thread ==============================================================================
+void VoicePool::noteOn (int midiNoteNumber, float velocity)
+{
+    pushEvent ({ midiNoteNumber, velocity, true });
+}
+
+void VoicePool::noteOff (int midiNoteNumber)
+{
+    pushEvent ({ midiNoteNumber, 0.0f, false });
+}
+
+void VoicePool::setWaveform (Wavetable::Waveform newWaveform)
+{
+    waveform = newWaveform;
+}
+
+void VoicePool::setParameters (const juce::ADSR::Parameters& parameters)
+{
+    attack = parameters.attack;
+    decay = parameters.decay;
+    sustain = parameters.sustain;
+    release = parameters.release;
+    parametersChanged = true;
+}
+
+juce::ADSR::Parameters VoicePool::getParameters() const
+{
+    return { attack.get(), decay.get(), sustain.get(), release.get() };
+}
+
+void VoicePool::pushEvent (const NoteEvent& event)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    // If the audio thread has fallen that far behind, the note is dropped
+    if (size1 > 0)
+    {
+        events[start1] = event;
+    }
+    fifo.finishedWrite (size1);
+}
+
+// Audio thread ==============================================================================
+void VoicePool::renderVoices (float* output, int numSamples)
+{
+    oscillators.clearEnvelopes (numSamples);
+
+    // Idle voices leave their lane silent, and the bank skips registers with no active lane
+    int numActive = 0;
+    for (int i = 0; i < voices.size(); ++i)
+    {
+        auto* voice = voices.getUnchecked (i);
+        oscillators.setLaneActive (i, voice->isActive());
+
+        if (voice->isActive())
+        {
+            voice->renderEnvelope (oscillators.getEnvelopes() + i, oscillators.getEnvelopeStride(), numSamples);
+            ++numActive;
+        }
+    }
+    numActiveVoices = numActive;
+
+    oscillators.render (output, numSamples);
+}
+
+void VoicePool::handleEvent (const NoteEvent& event)
+{
+    if (event.isNoteOn)
+    {
+        auto index = findVoiceToPlay (event.noteNumber);
+        if (index >= 0)
+        {
+            voices[index]->start (event.noteNumber, event.velocity, ++noteCounter);
+            oscillators.startVoice (index, (float) juce::MidiMessage::getMidiNoteInHertz (event.noteNumber), currentWaveform);
+        }
+        return;
+    }
+
+    for (auto* voice : voices)
+    {
+        if (voice->isActive() && ! voice->getIsReleasing() && voice->getNoteNumber() == event.noteNumber)
+        {
+            voice->stop();
+        }
+    }
+}
+
+int VoicePool::findVoiceToPlay (int midiNoteNumber)
+{
+    int freeVoice = -1;
+    int quietestReleasing = -1;
+    int oldest = -1;
+
+    for (int i = 0; i < voices.size(); ++i)
+    {
+        auto* voice = voices.getUnchecked (i);
+
+        // Retrigger a voice that is still ringing out the same note
+        if (voice->isActive() && voice->getNoteNumber() == midiNoteNumber)
+        {
+            return i;
+        }
+
+        if (! voice->isActive())
+        {
+            if (freeVoice < 0)
+            {
+                freeVoice = i;
+            }
+        }
+        else if (voice->getIsReleasing())
+        {
+            if (quietestReleasing < 0 || voice->getLevel() < voices[quietestReleasing]->getLevel())
+            {
+                quietestReleasing = i;
+            }
+        }
+        else if (oldest < 0 || voice->getNoteOrder() < voices[oldest]->getNoteOrder())
+        {
+            oldest = i;
+        }
+    }
+
+    // Prefer a free voice, then the quietest one that is releasing, then the oldest held note
+    if (freeVoice >= 0)
+    {
+        return freeVoice;
+    }
+
+    return quietestReleasing >= 0 ? quietestReleasing : oldest;
+}
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    VoicePool.h
+    Created: 17 Oct 2026 1:18:47pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Voice.h"
+
+// A fixed number of voices allocated in prepare(). Notes and parameter changes
+// arrive from the message thread through a lock-free FIFO and atomics, so
+// renderNextBlock() never allocates or waits on a lock. The oscillators of all
+// the voices run together in an OscillatorBank.
+class VoicePool
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec, int numVoices);
+    void renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+    // These can be called from the message thread while audio is running
+    void noteOn (int midiNoteNumber, float velocity);
+    void noteOff (int midiNoteNumber);
+    void setWaveform (Wavetable::Waveform newWaveform);
+    void setParameters (const juce::ADSR::Parameters& parameters);
+    juce::ADSR::Parameters getParameters() const;
+
+    int getNumActiveVoices() const
+    {
+        return numActiveVoices.get();
+    }
+
+private:
+    struct NoteEvent
+    {
+        int noteNumber;
+        float velocity;
+        bool isNoteOn;
+    };
+
+    void pushEvent (const NoteEvent& event);
+    void handleEvent (const NoteEvent& event);
+    void renderVoices (float* output, int numSamples);
+    int findVoiceToPlay (int midiNoteNumber);
+
+    WavetableBank bank;
+    OscillatorBank oscillators;
+    juce::OwnedArray<Voice> voices;
+    juce::uint32 noteCounter = 0;
+    Wavetable::Waveform currentWaveform = Wavetable::Waveform::sine;
+    float masterGain = 0.25f;
+
+    static constexpr int fifoSize = 256;
+    juce::AbstractFifo fifo { fifoSize };
+    NoteEvent events[fifoSize];
+
+    juce::Atomic<Wavetable::Waveform> waveform { Wavetable::Waveform::sine };
+    juce::Atomic<float> attack { 0.1f };
+    juce::Atomic<float> decay { 0.1f };
+    juce::Atomic<float> sustain { 1.0f };
+    juce::Atomic<float> release { 0.1f };
+    juce::Atomic<bool> parametersChanged { true };
+    juce::Atomic<int> numActiveVoices { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoicePool)
+};
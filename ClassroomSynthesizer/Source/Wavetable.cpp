@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    Wavetable.cpp
+    Created: 17 Oct 2026 10:12:41am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "Wavetable.h"
+
+void Wavetable::build (Waveform waveform, double sampleRate)
+{
+    auto nyquist = sampleRate / 2.0;
+    auto numTables = juce::jmax (1, (int) std::ceil (std::log2 (nyquist / minFrequency)));
+    tables.setSize (numTables, tableSize + 1);
+
+    juce::dsp::FFT fft (fftOrder);
+    juce::HeapBlock<float> spectrum (tableSize * 2, true);
+    auto peak = 0.0f;
+
+    for (int table = 0; table < numTables; ++table)
+    {
+        // The highest frequency this table plays before the next octave takes over
+        auto topFrequency = minFrequency * std::pow (2.0, table + 1);
+        auto numHarmonics = juce::jlimit (1, tableSize / 2 - 1, (int) (nyquist / topFrequency));
+
+        // Fill the imaginary parts so every harmonic is a sine, then go back to the time domain
+        juce::FloatVectorOperations::clear (spectrum, tableSize * 2);
+        for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+        {
+            spectrum[harmonic * 2 + 1] = -getHarmonicAmplitude (waveform, harmonic);
+        }
+        fft.performRealOnlyInverseTransform (spectrum);
+
+        auto* data = tables.getWritePointer (table);
+        juce::FloatVectorOperations::copy (data, spectrum, tableSize);
+        data[tableSize] = data[0];
+
+        peak = juce::jmax (peak, tables.getMagnitude (table, 0, tableSize));
+    }
+
+    // Normalise every table by the same amount so the level doesn't jump between octaves
+    if (peak > 0.0f)
+    {
+        tables.applyGain (1.0f / peak);
+    }
+}
+
+float Wavetable::getHarmonicAmplitude (Waveform waveform, int harmonic)
+{
+    auto isOdd = harmonic % 2 == 1;
+
+    switch (waveform)
+    {
+        case Waveform::sine:
+            return harmonic == 1 ? 1.0f : 0.0f;
+        case Waveform::sawtooth:
+            return 1.0f / (float) harmonic;
+        case Waveform::square:
+            return isOdd ? 1.0f / (float) harmonic : 0.0f;
+        case Waveform::triangle:
+            return isOdd ? ((harmonic / 2) % 2 == 0 ? 1.0f : -1.0f) / (float) (harmonic * harmonic) : 0.0f;
+    }
+
+    return 0.0f;
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    Wavetable.h
+    Created: 17 Oct 2026 10:12:41am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// A band-limited wavetable with one table per octave (a "mipmap"). Each table
+// only holds the harmonics that stay below Nyquist for the octave it covers,
+// so the oscillator reading it does not alias at 1x sample rate.
+class Wavetable
+{
+public:
+    enum class Waveform
+    {
+        sine,
+        sawtooth,
+        square,
+        triangle
+    };
+
+    // Builds all the octave tables. This allocates, so call it from prepareToPlay.
+    void build (Waveform waveform, double sampleRate);
+
+    int getNumTables() const
+    {
+        return tables.getNumChannels();
+    }
+
+    // Converts a playback frequency into a table position. The integer part picks
+    // the table and the fractional part is the crossfade amount to the next one.
+    float getTablePosition (float frequency) const noexcept
+    {
+        auto position = std::log2 (frequency / minFrequency);
+        return juce::jlimit (0.0f, (float) juce::jmax (0, getNumTables() - 1), position);
+    }
+
+    // Raw octave table, tableSize samples plus one guard sample
+    const float* getTable (int index) const noexcept
+    {
+        return tables.getReadPointer (index);
+    }
+
+    // Reads the table at a phase between 0 and 1
+    float getSample (float phase, float tablePosition) const noexcept
+    {
+        auto index = (int) tablePosition;
+        auto fade = tablePosition - (float) index;
+        auto sample = lookup (tables.getReadPointer (index), phase);
+
+        if (fade > 0.0f)
+        {
+            sample += fade * (lookup (tables.getReadPointer (index + 1), phase) - sample);
+        }
+
+        return sample;
+    }
+
+    static constexpr int fftOrder = 11;
+    static constexpr int tableSize = 1 << fftOrder;
+    static constexpr float minFrequency = 20.0f;
+
+private:
+    static float lookup (const float* table, float phase) noexcept
+    {
+        auto position = phase * (float) tableSize;
+        auto index = (int) position;
+        auto fraction = position - (float) index;
+
+        // A phase just below 1 can round up to tableSize, so wrap the index back
+        // into the table. The extra guard sample then covers index + 1.
+        index &= tableSize - 1;
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+
+    static float getHarmonicAmplitude (Waveform waveform, int harmonic);
+
+    juce::AudioBuffer<float> tables;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Wavetable)
+};
+
+// One Wavetable for every Waveform. They are all built up front and never
+// change afterwards, so the audio thread can switch between them freely.
+class WavetableBank
+{
+public:
+    void build (double sampleRate)
+    {
+        for (int waveform = 0; waveform < numWaveforms; ++waveform)
+        {
+            wavetables[waveform].build ((Wavetable::Waveform) waveform, sampleRate);
+        }
+    }
+
+    const Wavetable& get (Wavetable::Waveform waveform) const noexcept
+    {
+        return wavetables[(int) waveform];
+    }
+
+    static constexpr int numWaveforms = 4;
+
+private:
+    Wavetable wavetables[numWaveforms];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableBank)
+};
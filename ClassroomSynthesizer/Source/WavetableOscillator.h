@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    WavetableOscillator.h
+    Created: 17 Oct 2026 10:40:03am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Wavetable.h"
+
+// Drop-in replacement for juce::dsp::Oscillator inside a ProcessorChain that
+// plays a band-limited Wavetable and picks the octave table by frequency.
+class WavetableOscillator
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    // Safe to call from any thread. The audio thread picks the new waveform up
+    // at the start of the next block and crossfades into it.
+    void setWaveform (Wavetable::Waveform newWaveform) noexcept
+    {
+        targetWaveform = newWaveform;
+    }
+
+    void setFrequency (float newFrequency, bool force = false) noexcept;
+
+    // Plays the tables of a bank owned elsewhere (e.g. shared by all voices)
+    // instead of building a private one in prepare(). Call before prepare().
+    void setWavetableBank (const WavetableBank& sharedBank) noexcept
+    {
+        bank = &sharedBank;
+    }
+
+    float getFrequency() const noexcept
+    {
+        return frequency.getTargetValue();
+    }
+
+    // Call once per block before processSample() when not using process()
+    void updateWaveform() noexcept
+    {
+        auto newWaveform = targetWaveform.get();
+
+        // Let a running crossfade finish first, the latest request wins afterwards
+        if (newWaveform == currentWaveform || fadeSamplesRemaining > 0)
+        {
+            return;
+        }
+
+        previous = current;
+        current = &bank->get (newWaveform);
+        currentWaveform = newWaveform;
+        fadeSamplesRemaining = fadeLength;
+    }
+
+    float processSample() noexcept
+    {
+        if (frequency.isSmoothing())
+        {
+            updateIncrement (frequency.getNextValue());
+        }
+
+        auto sample = current->getSample (phase, tablePosition);
+
+        if (fadeSamplesRemaining > 0)
+        {
+            auto fade = (float) fadeSamplesRemaining / (float) fadeLength;
+            sample += fade * (previous->getSample (phase, tablePosition) - sample);
+            --fadeSamplesRemaining;
+        }
+
+        phase += increment;
+        if (phase >= 1.0f)
+        {
+            phase -= 1.0f;
+        }
+
+        return sample;
+    }
+
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& outBlock = context.getOutputBlock();
+        auto numChannels = outBlock.getNumChannels();
+        auto numSamples = outBlock.getNumSamples();
+
+        if (context.isBypassed)
+        {
+            outBlock.clear();
+            return;
+        }
+
+        updateWaveform();
+
+        // Render the first channel and copy it to the others
+        auto* channelDataOut = outBlock.getChannelPointer (0);
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            channelDataOut[sample] = processSample();
+        }
+
+        for (size_t channel = 1; channel < numChannels; ++channel)
+        {
+            juce::FloatVectorOperations::copy (outBlock.getChannelPointer (channel), channelDataOut, (int) numSamples);
+        }
+    }
+
+private:
+    void updateIncrement (float newFrequency) noexcept
+    {
+        increment = newFrequency / (float) sampleRate;
+        tablePosition = current->getTablePosition (newFrequency);
+    }
+
+    WavetableBank ownBank;
+    const WavetableBank* bank = &ownBank;
+    const Wavetable* current = &ownBank.get (Wavetable::Waveform::sine);
+    const Wavetable* previous = current;
+    Wavetable::Waveform currentWaveform = Wavetable::Waveform::sine;
+    juce::Atomic<Wavetable::Waveform> targetWaveform { Wavetable::Waveform::sine };
+
+    juce::SmoothedValue<float> frequency { 440.0f };
+
+    double sampleRate = 44100.0;
+    float phase = 0.0f;
+    float increment = 0.0f;
+    float tablePosition = 0.0f;
+    int fadeLength = 1;
+    int fadeSamplesRemaining = 0;
+};
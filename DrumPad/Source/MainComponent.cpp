@@ -14,6 +14,10 @@ MainComponent::MainComponent()
     // you add any child components.
     setSize (800, 600);
 
+    // Create the pads once, before audio starts. Their samples load once the device rate is known.
+    sampleCache->setUseCompactStorage (DRUMPAD_COMPACT_SAMPLES != 0);
+    createPads();
+
     // Some platforms require permissions to open input channels so request that here
     if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
         && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
@@ -41,23 +45,24 @@ MainComponent::~MainComponent()
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    createPads();
+    // Load the kit at the device rate, and again whenever that rate changes
+    if (sampleRate != kitSampleRate)
+    {
+        kitSampleRate = sampleRate;
+        loadPads (sampleRate);
+    }
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    for (int i = 0; i < pads.size(); ++i)
-    {
-        pads[i]->getNextAudioBlock (bufferToFill);
-    }
+    mixer.getNextAudioBlock (bufferToFill);
 }
 
 void MainComponent::releaseResources()
 {
-    for (int i = 0; i < pads.size(); ++i)
-    {
-        pads[i]->releaseResources();
-    }
+    // Nothing is playing now, so samples at an old rate can go
+    mixer.releaseResources();
+    sampleCache->releaseUnused();
 }
 
 //==============================================================================
@@ -93,7 +98,7 @@ void MainComponent::createPads()
         auto* entry = apkZip.getEntry (i);
         if (entry->filename.contains("assets/Sounds/"))
         {
-            pads.add (new Pad (entry->filename));
+            pads.add (new Pad (entry->filename, mixer));
         }
     }
 #elif JUCE_IOS
@@ -103,7 +108,45 @@ void MainComponent::createPads()
     auto files = soundDir.findChildFiles(juce::File::TypesOfFileToFind::findFiles, false, "*.wav");
     for (int i = 0; i < files.size(); ++i)
     {
-        pads.add (new Pad (files[i].getFullPathName()));
+        pads.add (new Pad (files[i].getFullPathName(), mixer));
     }
 #endif
 }
+
+void MainComponent::loadPads (double sampleRate)
+{
+    // Decode and convert in the background, so each pad becomes playable as soon as it is done
+    numPadsLoading += pads.size();
+    for (auto* pad : pads)
+    {
+        juce::Component::SafePointer<Pad> safePad (pad);
+        juce::Component::SafePointer<MainComponent> safeThis (this);
+        kitLoader.add ([pad, sampleRate] { pad->loadSample (sampleRate); },
+                       [safePad, safeThis]
+                       {
+                           if (safePad != nullptr) safePad->setReady();
+                           if (safeThis != nullptr) safeThis->padLoaded();
+                       });
+    }
+}
+
+void MainComponent::padLoaded()
+{
+    if (--numPadsLoading > 0)
+    {
+        return;
+    }
+
+   #if DRUMPAD_BENCHMARK
+    juce::Array<CachedSample::Ptr> kit;
+    for (auto* pad : pads)
+    {
+        if (auto sample = pad->getSample())
+        {
+            kit.add (sample);
+        }
+    }
+    juce::Logger::writeToLog (SampleVoiceMixer::runBenchmark (kit, mixer.getMaxVoices(), 64, 5000));
+    juce::Logger::writeToLog (SampleVoiceMixer::runBenchmark (kit, mixer.getMaxVoices(), 512, 1000));
+   #endif
+}
@@ -2,6 +2,18 @@
 
 #include <JuceHeader.h>
 #include "Pad.h"
+#include "KitLoader.h"
+
+// Set this to 1 in the Projucer preprocessor definitions to keep the kit as
+// 16-bit PCM, which takes half the memory of floats
+#ifndef DRUMPAD_COMPACT_SAMPLES
+ #define DRUMPAD_COMPACT_SAMPLES 0
+#endif
+
+// Set this to 1 to log how float and 16-bit storage compare on the kit once it has loaded
+#ifndef DRUMPAD_BENCHMARK
+ #define DRUMPAD_BENCHMARK 0
+#endif
 
 //==============================================================================
 /*
@@ -27,7 +39,18 @@ public:
 private:
     //==============================================================================
     void createPads();
+    void loadPads (double sampleRate);
+    void padLoaded();
+
+    // Plays every pad, so it has to outlive them
+    SampleVoiceMixer mixer;
     juce::OwnedArray<Pad> pads;
 
+    // Declared after pads so its jobs are finished before the pads are deleted
+    KitLoader kitLoader;
+    juce::SharedResourcePointer<SampleCache> sampleCache;
+    double kitSampleRate = 0.0;
+    int numPadsLoading = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -17,24 +17,29 @@
 #define  LOGD(...)  __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #endif
 
-Pad::Pad (juce::String fileName)
-    : juce::ShapeButton ("", juce::Colours::red, juce::Colours::red, juce::Colours::grey)
+Pad::Pad (juce::String fileName, SampleVoiceMixer& mixer)
+    : juce::ShapeButton ("", juce::Colours::red, juce::Colours::red, juce::Colours::grey),
+      fileName (fileName), sampleBuffer (mixer)
 {
-    // Load audio file
-    sampleBuffer.loadAudioFileFromAsset (fileName);
+    // Stay dimmed and untouchable until the sample is loaded
+    setEnabled (false);
+    setAlpha (0.3f);
+
+    sampleBuffer.setChokeGroup (SampleBuffer::getDefaultChokeGroup (fileName));
     
     // Tell the button that this class is the listener
     addListener (this);
 }
 
-void Pad::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+void Pad::loadSample (double sampleRate)
 {
-    sampleBuffer.getNextAudioBlock (bufferToFill);
+    sampleBuffer.loadAudioFileFromAsset (fileName, sampleRate);
 }
 
-void Pad::releaseResources()
+void Pad::setReady()
 {
-    sampleBuffer.releaseResources();
+    setEnabled (sampleBuffer.isLoaded());
+    setAlpha (sampleBuffer.isLoaded() ? 1.0f : 0.3f);
 }
 
 void Pad::paint(juce::Graphics& g)
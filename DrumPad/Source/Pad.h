@@ -16,14 +16,24 @@
 class Pad : public juce::ShapeButton, public juce::Button::Listener
 {
 public:
-    Pad (juce::String fileName);
+    Pad (juce::String fileName, SampleVoiceMixer& mixer);
     void buttonStateChanged (juce::Button *button) override;
     void buttonClicked (juce::Button *button) override;
     void paint(juce::Graphics& g) override;
-    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
-    void releaseResources();
+
+    // Decodes the sample and converts it to sampleRate. Runs on a KitLoader thread.
+    void loadSample (double sampleRate);
+
+    // Lets the pad be played once its sample is loaded
+    void setReady();
+
+    CachedSample::Ptr getSample() const
+    {
+        return sampleBuffer.getSample();
+    }
 
 private:
+    juce::String fileName;
     SampleBuffer sampleBuffer;
     juce::Path rectPath;
 
@@ -16,75 +16,58 @@
 #define  LOGD(...)  __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #endif
 
-void SampleBuffer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+// Play/Record managing ==============================================================================
+void SampleBuffer::enableLoop (bool isLooping)
 {
-    if (isPlaying)
-    {
-        auto numInputChannels = fileBuffer.getNumChannels();
-        auto numOutputChannels = bufferToFill.buffer->getNumChannels();
-        auto numSamples = bufferToFill.numSamples;
-
-        // Go through all the channels available
-        for (auto channel = 0; channel < numOutputChannels; ++channel)
-        {
-            // % numInputChannels is to compensate when the audio buffer and the main audio
-            // system do not agree on the number of channels.
-            auto* channelDataIn = fileBuffer.getReadPointer (channel % numInputChannels);
-            auto* channelDataOut = bufferToFill.buffer->getWritePointer (channel);
-
-            // mix in sample by sample to the main buffer
-            for (auto sample = 0; sample < numSamples; ++sample)
-            {
-                // if the reading position exceeds the size of buffer, break out of the loop
-                if (position + sample >= fileBuffer.getNumSamples()) break;
-                channelDataOut[sample] += channelDataIn[position + sample];
-            }
-        }
-
-        // Update the audio buffer reading position
-        position += numSamples;
+    this->isLooping = isLooping;
+}
 
-        // Stop the playback once the reading position reaches the size of buffer
-        if (position >= fileBuffer.getNumSamples())
-        {
-            if (!isLooping)
-            {
-                isPlaying = false;
-            }
-            else
-            {
-                position = 0;
-            }
-        }
+void SampleBuffer::play()
+{
+    // Nothing plays until the sample has finished loading
+    if (auto* current = loadedSample.get())
+    {
+        mixer.trigger (this, current, gain, pan, isLooping, maxPolyphony, chokeGroup);
     }
 }
 
-void SampleBuffer::releaseResources()
+void SampleBuffer::playAt (int sampleOffset, float velocity)
 {
-    fileBuffer.setSize (0, 0);
+    if (auto* current = loadedSample.get())
+    {
+        mixer.triggerAt (sampleOffset, this, current, gain * velocity, pan, isLooping, maxPolyphony, chokeGroup);
+    }
 }
 
-// Play/Record managing ==============================================================================
-void SampleBuffer::enableLoop (bool isLooping)
+void SampleBuffer::stop()
 {
-    this->isLooping = isLooping;
+    mixer.stop (this);
 }
 
-void SampleBuffer::play()
+int SampleBuffer::getDefaultChokeGroup (const juce::String& fileName)
 {
-    if(!isPlaying) isPlaying = true;
-    position = 0;
+    auto name = fileName.fromLastOccurrenceOf ("/", false, false).upToFirstOccurrenceOf (".", false, false);
+    return (name == "CH" || name == "CHH" || name == "OH") ? 1 : 0;
 }
 
-void SampleBuffer::stop()
+// File Operations ==============================================================================
+void SampleBuffer::loadAudioFileFromAsset (juce::String fileName, double sampleRate)
 {
-    if (isPlaying) isPlaying = false;
+    const juce::ScopedLock sl (loadLock);
+
+    // Only the first buffer asking for an asset at this rate decodes and converts it, the rest share it
+    auto loaded = cache->load (fileName, [fileName] { return openAsset (fileName); }, sampleRate);
+    if (loaded != nullptr)
+    {
+        // Publish the sample only once it is complete
+        sample = loaded;
+        loadedSample.set (sample.get());
+    }
 }
 
-// File Operations ==============================================================================
-void SampleBuffer::loadAudioFileFromAsset (juce::String fileName)
+std::unique_ptr<juce::InputStream> SampleBuffer::openAsset (const juce::String& fileName)
 {
-std::unique_ptr<juce::InputStream> inputStream;
+    std::unique_ptr<juce::InputStream> inputStream;
 #if JUCE_ANDROID
     juce::ZipFile apkZip (juce::File::getSpecialLocation (juce::File::invokedExecutableFile));
     inputStream = std::unique_ptr<juce::InputStream> (apkZip.createStreamForEntry (apkZip.getIndexOfFileName (fileName)));
@@ -93,14 +76,5 @@ std::unique_ptr<juce::InputStream> inputStream;
     jassert (file.existsAsFile());
     inputStream = file.createInputStream();
 #endif
-    // Once file opening succeeds, create a reader
-    auto* reader = formatManager.createReaderFor (std::move (inputStream));
-    if (reader != nullptr)
-    {
-        // Set the size and channel number for the audio buffer based on the sound file we read
-        fileBuffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
-        
-        // Read the file content and write it in the audio buffer
-        reader->read (&fileBuffer, 0, (int) reader->lengthInSamples, 0, true, true);
-    }
+    return inputStream;
 }
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    SampleCache.cpp
+    Created: 18 Oct 2026 11:20:44am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "SampleCache.h"
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+#elif defined (__SSE2__)
+ #include <emmintrin.h>
+#endif
+
+CachedSample::CachedSample (const juce::String& key, juce::AudioBuffer<float>&& decoded, double sampleRate,
+                            bool isResampled, bool isCompact)
+    : key (key), buffer (std::move (decoded)),
+      numChannels (buffer.getNumChannels()), numSamples (buffer.getNumSamples()),
+      sampleRate (sampleRate), isResampled (isResampled)
+{
+    if (isCompact)
+    {
+        // One scale for the whole asset, chosen so its peak uses the full 16-bit range
+        auto peak = buffer.getMagnitude (0, numSamples);
+        compactScale = peak > 0.0f ? peak / 32767.0f : 1.0f;
+
+        compactData.malloc ((size_t) numChannels * (size_t) numSamples);
+        for (auto channel = 0; channel < numChannels; ++channel)
+        {
+            auto* source = buffer.getReadPointer (channel);
+            auto* dest = compactData + (size_t) channel * (size_t) numSamples;
+
+            for (auto i = 0; i < numSamples; ++i)
+            {
+                dest[i] = (juce::int16) juce::roundToInt (source[i] / compactScale);
+            }
+        }
+
+        // The floats are no longer needed
+        buffer.setSize (0, 0);
+    }
+}
+
+size_t CachedSample::getMemoryUsage() const
+{
+    return (size_t) numChannels * (size_t) numSamples * (isCompact() ? sizeof (juce::int16) : sizeof (float));
+}
+
+juce::AudioBuffer<float> CachedSample::toFloatBuffer() const
+{
+    if (! isCompact())
+    {
+        return buffer;
+    }
+
+    juce::AudioBuffer<float> result (numChannels, numSamples);
+    for (auto channel = 0; channel < numChannels; ++channel)
+    {
+        expand (getCompactData (channel), result.getWritePointer (channel), compactScale, numSamples);
+    }
+    return result;
+}
+
+CachedSample::Ptr CachedSample::createCopy (bool compact) const
+{
+    return new CachedSample (key, toFloatBuffer(), sampleRate, isResampled, compact);
+}
+
+void CachedSample::expand (const juce::int16* source, float* dest, float scale, int numSamples)
+{
+    auto i = 0;
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+    auto scaleVector = vdupq_n_f32 (scale);
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        auto samples = vld1q_s16 (source + i);
+        vst1q_f32 (dest + i,     vmulq_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (samples))), scaleVector));
+        vst1q_f32 (dest + i + 4, vmulq_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (samples))), scaleVector));
+    }
+#elif defined (__SSE2__)
+    auto scaleVector = _mm_set1_ps (scale);
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        // Unpacking a value with itself and shifting right by 16 sign-extends it to 32 bits
+        auto samples = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i));
+        auto low = _mm_srai_epi32 (_mm_unpacklo_epi16 (samples, samples), 16);
+        auto high = _mm_srai_epi32 (_mm_unpackhi_epi16 (samples, samples), 16);
+        _mm_storeu_ps (dest + i,     _mm_mul_ps (_mm_cvtepi32_ps (low), scaleVector));
+        _mm_storeu_ps (dest + i + 4, _mm_mul_ps (_mm_cvtepi32_ps (high), scaleVector));
+    }
+#endif
+
+    // Whatever is left over, or everything on other platforms
+    for (; i < numSamples; ++i)
+    {
+        dest[i] = (float) source[i] * scale;
+    }
+}
+
+CachedSample::Ptr SampleCache::load (const juce::String& key, const StreamOpener& openStream, double sampleRate)
+{
+    CachedSample::Ptr original;
+    {
+        const juce::ScopedLock sl (lock);
+        if (auto existing = find (key, sampleRate))
+        {
+            return existing;
+        }
+        original = findOriginal (key);
+    }
+
+    juce::AudioBuffer<float> buffer;
+    double fileSampleRate = 0.0;
+
+    // Convert from the file's own rate if something already keeps it, rather than decoding again
+    if (original != nullptr)
+    {
+        if (sampleRate <= 0.0)
+        {
+            return original;
+        }
+        buffer = original->toFloatBuffer();
+        fileSampleRate = original->getSampleRate();
+    }
+    else if (! decode (openStream, buffer, fileSampleRate))
+    {
+        return nullptr;
+    }
+
+    auto isResampled = sampleRate > 0.0 && fileSampleRate != sampleRate;
+    if (isResampled)
+    {
+        // Convert once here so playback stays a plain copy at the device rate.
+        // The decode at the file's rate is dropped rather than cached next to it.
+        buffer = resample (buffer, fileSampleRate / sampleRate);
+    }
+
+    const juce::ScopedLock sl (lock);
+
+    // Someone else may have loaded the same asset in the meantime
+    if (auto existing = isResampled ? find (key, sampleRate) : findOriginal (key))
+    {
+        return existing;
+    }
+
+    CachedSample::Ptr sample (new CachedSample (key, std::move (buffer), isResampled ? sampleRate : fileSampleRate,
+                                                isResampled, useCompactStorage));
+    samples.add (sample);
+    return sample;
+}
+
+bool SampleCache::decode (const StreamOpener& openStream, juce::AudioBuffer<float>& buffer, double& fileSampleRate)
+{
+    // Decode outside the lock so different assets can load at the same time
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (openStream()));
+    if (reader == nullptr)
+    {
+        return false;
+    }
+
+    buffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+    reader->read (&buffer, 0, (int) reader->lengthInSamples, 0, true, true);
+    fileSampleRate = reader->sampleRate;
+    return true;
+}
+
+juce::AudioBuffer<float> SampleCache::resample (const juce::AudioBuffer<float>& source, double speedRatio)
+{
+    auto numInputSamples = source.getNumSamples();
+    auto numOutputSamples = (int) std::ceil (numInputSamples / speedRatio);
+
+    // The interpolator runs behind its input, so render that much extra and skip it
+    auto latency = (int) std::ceil (juce::WindowedSincInterpolator().getBaseLatency() / speedRatio);
+
+    juce::AudioBuffer<float> result (source.getNumChannels(), numOutputSamples);
+    juce::HeapBlock<float> scratch ((size_t) (numOutputSamples + latency));
+
+    for (auto channel = 0; channel < source.getNumChannels(); ++channel)
+    {
+        // Past the end of the sample the interpolator reads silence
+        juce::WindowedSincInterpolator interpolator;
+        interpolator.process (speedRatio, source.getReadPointer (channel), scratch.get(),
+                              numOutputSamples + latency, numInputSamples, 0);
+        result.copyFrom (channel, 0, scratch.get() + latency, numOutputSamples);
+    }
+
+    return result;
+}
+
+void SampleCache::releaseUnused()
+{
+    const juce::ScopedLock sl (lock);
+
+    // The cache holds one reference itself, so anything at 1 is unused
+    for (int i = samples.size(); --i >= 0;)
+    {
+        if (samples.getObjectPointerUnchecked (i)->getReferenceCount() == 1)
+        {
+            samples.remove (i);
+        }
+    }
+}
+
+size_t SampleCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl (lock);
+
+    size_t total = 0;
+    for (auto* sample : samples)
+    {
+        total += sample->getMemoryUsage();
+    }
+    return total;
+}
+
+CachedSample::Ptr SampleCache::find (const juce::String& key, double sampleRate) const
+{
+    for (auto* sample : samples)
+    {
+        if (sample->getKey() == key && (sampleRate <= 0.0 ? !sample->getIsResampled()
+                                                          : sample->getSampleRate() == sampleRate))
+        {
+            return sample;
+        }
+    }
+
+    return nullptr;
+}
+
+CachedSample::Ptr SampleCache::findOriginal (const juce::String& key) const
+{
+    return find (key, 0.0);
+}
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    SampleCache.h
+    Created: 18 Oct 2026 11:20:44am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Decoded audio for one asset at one sample rate. It never changes after
+// loading, so any thread can read it, and every SampleBuffer playing the
+// asset shares the same copy.
+//
+// A compact sample keeps 16-bit PCM and one scale for the whole asset instead
+// of floats, which halves its memory. Read it with getCompactData() and
+// expand() rather than getBuffer().
+class CachedSample : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<CachedSample>;
+
+    CachedSample (const juce::String& key, juce::AudioBuffer<float>&& decoded, double sampleRate,
+                  bool isResampled, bool isCompact = false);
+
+    const juce::String& getKey() const
+    {
+        return key;
+    }
+
+    // Float samples. Empty when the sample is compact.
+    const juce::AudioBuffer<float>& getBuffer() const
+    {
+        jassert (! isCompact());
+        return buffer;
+    }
+
+    bool isCompact() const
+    {
+        return compactData != nullptr;
+    }
+
+    // 16-bit samples for a channel of a compact sample. Multiply by getCompactScale() to get floats.
+    const juce::int16* getCompactData (int channel) const
+    {
+        return compactData + (size_t) channel * (size_t) numSamples;
+    }
+
+    float getCompactScale() const
+    {
+        return compactScale;
+    }
+
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    int getNumSamples() const
+    {
+        return numSamples;
+    }
+
+    double getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    // False for the file as it was decoded, true for a copy converted to another rate
+    bool getIsResampled() const
+    {
+        return isResampled;
+    }
+
+    // Bytes held by the sample data
+    size_t getMemoryUsage() const;
+
+    // Float copy of the whole sample, whichever way it is stored
+    juce::AudioBuffer<float> toFloatBuffer() const;
+
+    // The same audio in the other storage format
+    Ptr createCopy (bool compact) const;
+
+    // Turns 16-bit samples into floats times scale, eight at a time with SIMD where available
+    static void expand (const juce::int16* source, float* dest, float scale, int numSamples);
+
+private:
+    juce::String key;
+    juce::AudioBuffer<float> buffer;
+    juce::HeapBlock<juce::int16> compactData;
+    float compactScale = 1.0f;
+    int numChannels;
+    int numSamples;
+    double sampleRate;
+    bool isResampled;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedSample)
+};
+
+// Every asset is decoded once, however many pads, tracks or metronomes use it,
+// and converted once to each device rate it is played at. Hold one with
+// juce::SharedResourcePointer<SampleCache> so the whole app shares a single cache.
+class SampleCache
+{
+public:
+    using StreamOpener = std::function<std::unique_ptr<juce::InputStream>()>;
+
+    SampleCache()
+    {
+        // Register the audio formats that come with JUCE
+        formatManager.registerBasicFormats();
+    }
+
+    // Returns the sample for key at sampleRate, decoding it from openStream and
+    // resampling it the first time. A sampleRate of 0 keeps the file's own rate.
+    // Only the converted copy is cached, so asking for the same asset at another
+    // rate decodes the file again unless its own rate is cached too.
+    // Returns nullptr if it can't be read. Never call this from the audio thread.
+    CachedSample::Ptr load (const juce::String& key, const StreamOpener& openStream, double sampleRate = 0.0);
+
+    // Frees the samples that nothing is playing any more. Stale rates stay
+    // alive until this is called, so only call it while the audio device is stopped.
+    void releaseUnused();
+
+    // Opt in to 16-bit storage for samples loaded from now on. Off by default.
+    void setUseCompactStorage (bool shouldUseCompactStorage)
+    {
+        useCompactStorage = shouldUseCompactStorage;
+    }
+
+    int getNumSamples() const
+    {
+        const juce::ScopedLock sl (lock);
+        return samples.size();
+    }
+
+    // Bytes held by every cached sample
+    size_t getMemoryUsage() const;
+
+private:
+    CachedSample::Ptr find (const juce::String& key, double sampleRate) const;
+    CachedSample::Ptr findOriginal (const juce::String& key) const;
+    bool decode (const StreamOpener& openStream, juce::AudioBuffer<float>& buffer, double& fileSampleRate);
+    static juce::AudioBuffer<float> resample (const juce::AudioBuffer<float>& source, double speedRatio);
+
+    juce::AudioFormatManager formatManager;
+    juce::ReferenceCountedArray<CachedSample> samples;
+    juce::CriticalSection lock;
+    std::atomic<bool> useCompactStorage { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleCache)
+};
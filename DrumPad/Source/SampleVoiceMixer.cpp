@@ -0,0 +1,424 @@
+/*
+  ==============================================================================
+
+    SampleVoiceMixer.cpp
+    Created: 18 Oct 2026 2:40:37pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "SampleVoiceMixer.h"
+
+SampleVoiceMixer::SampleVoiceMixer (int maxVoices)
+    : voices ((size_t) (maxVoices + spareVoices)), maxVoices (maxVoices)
+{
+    jassert (maxVoices > 0);
+}
+
+void SampleVoiceMixer::trigger (const void* source, const CachedSample* sample, float gain, float pan, bool isLooping,
+                                int maxPolyphony, int chokeGroup)
+{
+    if (sample == nullptr || sample->getNumSamples() == 0)
+    {
+        return;
+    }
+
+    Command command;
+    command.type = Command::Type::play;
+    command.voice = makeVoice (source, sample, gain, pan, isLooping, chokeGroup);
+    command.maxPolyphony = juce::jmax (1, maxPolyphony);
+    push (command);
+}
+
+void SampleVoiceMixer::triggerAt (int sampleOffset, const void* source, const CachedSample* sample, float gain, float pan,
+                                  bool isLooping, int maxPolyphony, int chokeGroup)
+{
+    if (sample == nullptr || sample->getNumSamples() == 0)
+    {
+        return;
+    }
+
+    auto voice = makeVoice (source, sample, gain, pan, isLooping, chokeGroup);
+    voice.startOffset = juce::jmax (0, sampleOffset);
+    startVoice (voice, juce::jmax (1, maxPolyphony));
+}
+
+SampleVoiceMixer::Voice SampleVoiceMixer::makeVoice (const void* source, const CachedSample* sample, float gain, float pan,
+                                                     bool isLooping, int chokeGroup)
+{
+    // Balance pan, so a centred voice plays at full level on both sides
+    pan = juce::jlimit (-1.0f, 1.0f, pan);
+
+    Voice voice;
+    voice.source = source;
+    voice.sample = sample;
+    voice.position = 0;
+    voice.startOffset = 0;
+    voice.leftGain = gain * juce::jmin (1.0f, 1.0f - pan);
+    voice.rightGain = gain * juce::jmin (1.0f, 1.0f + pan);
+    voice.isLooping = isLooping;
+    voice.chokeGroup = chokeGroup;
+    voice.order = 0;
+    voice.isReleasing = false;
+    voice.fadeLeft = 0;
+    return voice;
+}
+
+void SampleVoiceMixer::stop (const void* source)
+{
+    Command command;
+    command.type = Command::Type::stop;
+    command.voice.source = source;
+    command.maxPolyphony = 0;
+    push (command);
+}
+
+void SampleVoiceMixer::push (const Command& command)
+{
+    // The fifo has a single writer, so writers take turns. The audio thread never takes this lock.
+    const juce::SpinLock::ScopedLockType sl (writeLock);
+
+    int start1, size1, start2, size2;
+    commandFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        commands[start1] = command;
+    }
+    commandFifo.finishedWrite (size1);
+}
+
+void SampleVoiceMixer::handleCommands()
+{
+    int start1, size1, start2, size2;
+    commandFifo.prepareToRead (commandFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1 + size2; ++i)
+    {
+        const auto& command = commands[i < size1 ? start1 + i : start2 + i - size1];
+
+        if (command.type == Command::Type::play)
+        {
+            startVoice (command.voice, command.maxPolyphony);
+        }
+        else
+        {
+            releaseVoices (command.voice.source);
+        }
+    }
+    commandFifo.finishedRead (size1 + size2);
+}
+
+void SampleVoiceMixer::startVoice (const Voice& voice, int maxPolyphony)
+{
+    // A new hit chokes everything else in its group, like a closed hat cutting an open one
+    if (voice.chokeGroup != 0)
+    {
+        for (int i = 0; i < numVoices; ++i)
+        {
+            if (voices[i].chokeGroup == voice.chokeGroup && voices[i].source != voice.source)
+            {
+                releaseVoice (voices[i], voice.startOffset);
+            }
+        }
+    }
+
+    // Let the previous hits of this source ring on, up to its polyphony
+    for (;;)
+    {
+        auto numPlaying = 0;
+        for (int i = 0; i < numVoices; ++i)
+        {
+            if (voices[i].source == voice.source && !voices[i].isReleasing) ++numPlaying;
+        }
+
+        if (numPlaying < maxPolyphony) break;
+        releaseVoice (voices[findOldestVoice (voice.source)], voice.startOffset);
+    }
+
+    // With every voice playing, the oldest fades out in a spare slot to make room
+    auto numPlaying = 0;
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (!voices[i].isReleasing) ++numPlaying;
+    }
+
+    if (numPlaying >= maxVoices)
+    {
+        releaseVoice (voices[findVoiceToSteal()], voice.startOffset);
+    }
+
+    // Only with the spare slots full of fading voices too does one have to go straight away
+    if (numVoices == maxVoices + spareVoices)
+    {
+        voices[findQuietestVoice()] = voices[--numVoices];
+    }
+
+    voices[numVoices] = voice;
+    voices[numVoices].order = nextOrder++;
+    ++numVoices;
+}
+
+void SampleVoiceMixer::releaseVoice (Voice& voice, int sampleOffset)
+{
+    if (!voice.isReleasing)
+    {
+        // fadeLeft counts from where the voice starts in this block. A voice
+        // released before it even starts is never heard.
+        voice.isReleasing = true;
+        voice.fadeLeft = sampleOffset >= voice.startOffset ? declickSamples + sampleOffset - voice.startOffset : 0;
+    }
+}
+
+void SampleVoiceMixer::releaseVoices (const void* source)
+{
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (voices[i].source == source)
+        {
+            releaseVoice (voices[i], 0);
+        }
+    }
+}
+
+int SampleVoiceMixer::findOldestVoice (const void* source) const
+{
+    auto oldest = -1;
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (voices[i].source == source && !voices[i].isReleasing
+            && (oldest < 0 || voices[i].order < voices[oldest].order))
+        {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+int SampleVoiceMixer::findVoiceToSteal() const
+{
+    // The oldest voice that is still playing
+    auto oldest = -1;
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (!voices[i].isReleasing && (oldest < 0 || voices[i].order < voices[oldest].order))
+        {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+int SampleVoiceMixer::findQuietestVoice() const
+{
+    // A voice that is already fading out is the least missed, the nearer the end the better.
+    // Otherwise take the oldest.
+    auto best = 0;
+    for (int i = 1; i < numVoices; ++i)
+    {
+        const auto& voice = voices[i];
+        const auto& current = voices[best];
+
+        if (voice.isReleasing != current.isReleasing)
+        {
+            if (voice.isReleasing) best = i;
+        }
+        else if (voice.isReleasing ? voice.fadeLeft < current.fadeLeft
+                                   : voice.order < current.order)
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void SampleVoiceMixer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    handleCommands();
+
+    auto numOutputChannels = bufferToFill.buffer->getNumChannels();
+    auto numSamples = bufferToFill.numSamples;
+
+    // One pass over each output channel, adding every active voice into it
+    for (auto channel = 0; channel < numOutputChannels; ++channel)
+    {
+        auto* out = bufferToFill.buffer->getWritePointer (channel, bufferToFill.startSample);
+
+        for (int i = 0; i < numVoices; ++i)
+        {
+            mixVoice (voices[i], channel, numOutputChannels, out, numSamples);
+        }
+    }
+
+    // Move the voices on, and drop the ones that reached the end of their sample or fade
+    for (int i = numVoices; --i >= 0;)
+    {
+        auto& voice = voices[i];
+        auto length = voice.sample->getNumSamples();
+        auto numPlayed = numSamples - voice.startOffset;
+        voice.position += numPlayed;
+        voice.startOffset = 0;
+
+        auto finished = false;
+        if (voice.isReleasing)
+        {
+            voice.fadeLeft -= numPlayed;
+            finished = voice.fadeLeft <= 0;
+        }
+
+        if (voice.position >= length)
+        {
+            if (voice.isLooping)
+            {
+                voice.position %= length;
+            }
+            else
+            {
+                finished = true;
+            }
+        }
+
+        if (finished)
+        {
+            voice = voices[--numVoices];
+        }
+    }
+
+    numActiveVoices.set (numVoices);
+}
+
+void SampleVoiceMixer::mixVoice (const Voice& voice, int channel, int numOutputChannels, float* out, int numSamples) const
+{
+    const auto& sample = *voice.sample;
+    auto length = sample.getNumSamples();
+
+    // % getNumChannels() covers a mono sample playing on a stereo device
+    auto sampleChannel = channel % sample.getNumChannels();
+    auto gain = (numOutputChannels == 1 || channel % 2 == 0) ? voice.leftGain : voice.rightGain;
+    auto position = voice.position;
+
+    // A voice triggered partway through the block starts at its own sample
+    out += voice.startOffset;
+    numSamples -= voice.startOffset;
+
+    // Compact samples fold their scale into the gain
+    const float* in = nullptr;
+    const juce::int16* compactIn = nullptr;
+    if (sample.isCompact())
+    {
+        compactIn = sample.getCompactData (sampleChannel);
+        gain *= sample.getCompactScale();
+    }
+    else
+    {
+        in = sample.getBuffer().getReadPointer (sampleChannel);
+    }
+
+    if (voice.isReleasing)
+    {
+        // Hold until the release point, then ramp down over the last declickSamples.
+        // It is short, so sample by sample is fine.
+        auto step = gain / (float) declickSamples;
+        auto num = juce::jmin (numSamples, voice.fadeLeft);
+
+        for (auto i = 0; i < num; ++i)
+        {
+            auto level = step * (float) juce::jmin (voice.fadeLeft - i, (int) declickSamples);
+            out[i] += (in != nullptr ? in[position] : (float) compactIn[position]) * level;
+
+            if (++position >= length)
+            {
+                if (!voice.isLooping) break;
+                position = 0;
+            }
+        }
+        return;
+    }
+
+    // Copy in runs that stop at the end of the sample instead of checking every index
+    auto done = 0;
+    while (done < numSamples)
+    {
+        auto num = juce::jmin (numSamples - done, length - position);
+
+        if (in != nullptr)
+        {
+            juce::FloatVectorOperations::addWithMultiply (out + done, in + position, gain, num);
+        }
+        else
+        {
+            // Expand to floats a cache-sized chunk at a time, then add
+            float expanded[expandSize];
+            for (auto offset = 0; offset < num; offset += expandSize)
+            {
+                auto chunk = juce::jmin ((int) expandSize, num - offset);
+                CachedSample::expand (compactIn + position + offset, expanded, gain, chunk);
+                juce::FloatVectorOperations::add (out + done + offset, expanded, chunk);
+            }
+        }
+
+        done += num;
+        position += num;
+
+        if (position >= length)
+        {
+            if (!voice.isLooping) break;
+            position = 0;
+        }
+    }
+}
+
+void SampleVoiceMixer::releaseResources()
+{
+    handleCommands();
+    numVoices = 0;
+    numActiveVoices.set (0);
+}
+
+juce::String SampleVoiceMixer::runBenchmark (const juce::Array<CachedSample::Ptr>& kit, int numVoices, int blockSize, int numBlocks)
+{
+    if (kit.isEmpty())
+    {
+        return "SampleVoiceMixer benchmark: no samples loaded";
+    }
+
+    juce::String report;
+    report << "SampleVoiceMixer benchmark, " << numVoices << " voices, " << blockSize << " samples x " << numBlocks << " blocks\n";
+
+    juce::AudioBuffer<float> output (2, blockSize);
+    juce::HeapBlock<char> sources ((size_t) numVoices);
+
+    for (auto compact : { false, true })
+    {
+        // Copies of the kit in one storage format
+        juce::ReferenceCountedArray<CachedSample> samples;
+        size_t bytes = 0;
+        for (auto& sample : kit)
+        {
+            samples.add (sample->createCopy (compact));
+            bytes += samples.getLast()->getMemoryUsage();
+        }
+
+        // Looping voices spread across the kit keep the mixer fully loaded for the whole run
+        SampleVoiceMixer mixer (numVoices);
+        for (int i = 0; i < numVoices; ++i)
+        {
+            mixer.trigger (sources + i, samples[i % samples.size()].get(), 0.5f, 0.0f, true);
+        }
+
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            output.clear();
+            mixer.getNextAudioBlock (juce::AudioSourceChannelInfo (output));
+        }
+        auto elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+
+        report << (compact ? "  int16: " : "  float: ")
+               << juce::String ((double) bytes / 1024.0, 1) << " KB, "
+               << juce::String (elapsed * 1000.0 / numBlocks, 2) << " us per block\n";
+    }
+
+    return report;
+}
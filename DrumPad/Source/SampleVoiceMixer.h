@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    SampleVoiceMixer.h
+    Created: 18 Oct 2026 2:40:37pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SampleCache.h"
+
+// Plays every triggered sample in the app from one place. Only the voices
+// that are sounding are visited, each one is mixed with whole-block vector
+// adds split at the end of its sample, and every output channel is written
+// in a single pass.
+//
+// Voices come from a pool allocated up front, so triggering never allocates.
+// A sample can overlap itself up to its polyphony, voices in the same choke
+// group cut each other off, and anything that is cut off fades out briefly
+// instead of clicking. That includes the voice stolen when all maxVoices are
+// playing, which fades out in one of a few spare slots kept for that.
+class SampleVoiceMixer
+{
+public:
+    explicit SampleVoiceMixer (int maxVoices = 64);
+
+    // Any thread except the audio thread. source identifies who triggered the
+    // voice so that stop() can find it again. chokeGroup 0 chokes nothing.
+    void trigger (const void* source, const CachedSample* sample, float gain, float pan, bool isLooping,
+                  int maxPolyphony = 1, int chokeGroup = 0);
+    void stop (const void* source);
+
+    // Audio thread, before getNextAudioBlock for the same block. Starts the
+    // voice sampleOffset samples into that block.
+    void triggerAt (int sampleOffset, const void* source, const CachedSample* sample, float gain, float pan,
+                    bool isLooping, int maxPolyphony = 1, int chokeGroup = 0);
+
+    // Audio thread. Adds the active voices to the buffer.
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
+
+    // Silences everything. Only call this while the audio device is stopped.
+    void releaseResources();
+
+    int getNumActiveVoices() const
+    {
+        return numActiveVoices.get();
+    }
+
+    int getMaxVoices() const
+    {
+        return maxVoices;
+    }
+
+    // Length of the fade when a voice is stopped, choked or stolen
+    static constexpr int declickSamples = 64;
+
+    // Slots on top of maxVoices for voices that are fading out. Only when more
+    // than this many are fading at once is the one closest to silence cut short.
+    static constexpr int spareVoices = 16;
+
+    // Times numVoices looping voices over the kit, with the samples stored as
+    // floats and then as 16-bit, and reports the memory and time per block of each
+    static juce::String runBenchmark (const juce::Array<CachedSample::Ptr>& kit, int numVoices, int blockSize, int numBlocks);
+
+private:
+    struct Voice
+    {
+        const void* source;
+        const CachedSample* sample;
+        int position;
+
+        // Where in the current block the voice begins, 0 once it has started
+        int startOffset;
+        float leftGain;
+        float rightGain;
+        bool isLooping;
+        int chokeGroup;
+
+        // Started later means a higher number, so the oldest voice is easy to find
+        juce::uint32 order;
+
+        // Samples left, counted from the voice's start in this block, before a released voice is silent
+        bool isReleasing;
+        int fadeLeft;
+    };
+
+    struct Command
+    {
+        enum class Type
+        {
+            play,
+            stop
+        };
+
+        Type type;
+        Voice voice;
+        int maxPolyphony;
+    };
+
+    void push (const Command& command);
+    void handleCommands();
+    static Voice makeVoice (const void* source, const CachedSample* sample, float gain, float pan,
+                            bool isLooping, int chokeGroup);
+    void startVoice (const Voice& voice, int maxPolyphony);
+    void releaseVoice (Voice& voice, int sampleOffset);
+    void releaseVoices (const void* source);
+    int findOldestVoice (const void* source) const;
+    int findVoiceToSteal() const;
+    int findQuietestVoice() const;
+    void mixVoice (const Voice& voice, int channel, int numOutputChannels, float* out, int numSamples) const;
+
+    // Compact samples are expanded through a stack buffer this long
+    static constexpr int expandSize = 256;
+
+    // Voices [0, numVoices) are the active ones, packed at the front. There are
+    // maxVoices + spareVoices in all.
+    juce::HeapBlock<Voice> voices;
+    const int maxVoices;
+    int numVoices = 0;
+    juce::uint32 nextOrder = 0;
+    juce::Atomic<int> numActiveVoices { 0 };
+
+    // Commands from other threads, read at the start of each block
+    static constexpr int commandCapacity = 256;
+    juce::AbstractFifo commandFifo { commandCapacity };
+    Command commands[commandCapacity];
+    juce::SpinLock writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleVoiceMixer)
+};
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    AudioEventQueue.cpp
+    Created: 18 Oct 2026 10:37:26pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "AudioEventQueue.h"
+
+AudioEventQueue::AudioEventQueue (int capacity)
+    : fifo (capacity), events ((size_t) capacity)
+{
+    startTimerHz (60);
+}
+
+bool AudioEventQueue::post (Event::Type type, int value)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    events[size1 > 0 ? start1 : start2] = { type, value };
+    fifo.finishedWrite (1);
+    return true;
+}
+
+void AudioEventQueue::postLatest (Event::Type type, int value)
+{
+    // The value goes in before the flag, so a drain that sees the flag sees this value or a newer one
+    latestValues[(int) type] = value;
+    hasLatest[(int) type] = true;
+}
+
+int AudioEventQueue::drain()
+{
+    auto numLatest = 0;
+    for (auto type = 0; type < numTypes; ++type)
+    {
+        if (hasLatest[type].exchange (false))
+        {
+            if (handler != nullptr)
+            {
+                handler ({ (Event::Type) type, latestValues[type].get() });
+            }
+            ++numLatest;
+        }
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    // The events are copied out before the handler runs, so it may post more
+    for (auto i = 0; i < size1 + size2; ++i)
+    {
+        auto event = events[i < size1 ? start1 + i : start2 + i - size1];
+        if (handler != nullptr)
+        {
+            handler (event);
+        }
+    }
+
+    fifo.finishedRead (size1 + size2);
+    return numLatest + size1 + size2;
+}
+
+juce::String AudioEventQueue::runStressTest (double sampleRate, int blockSize, int numBlocks)
+{
+    // Calls callback once per block at the device's pace, and times each call against the block's length
+    class FakeAudioThread : public juce::Thread
+    {
+    public:
+        FakeAudioThread (std::function<void()> callback, double blockMs, int numBlocks)
+            : juce::Thread ("Fake Audio Thread"), callback (std::move (callback)), blockMs (blockMs), numBlocks (numBlocks)
+        {
+        }
+
+        void run() override
+        {
+            auto due = juce::Time::getMillisecondCounterHiRes();
+            for (auto block = 0; block < numBlocks && ! threadShouldExit(); ++block)
+            {
+                auto startTime = juce::Time::getMillisecondCounterHiRes();
+                callback();
+                auto time = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+                worstMs = juce::jmax (worstMs, time);
+                if (time > blockMs)
+                {
+                    ++numOverruns;
+                }
+
+                due += blockMs;
+                while (juce::Time::getMillisecondCounterHiRes() < due)
+                {
+                    juce::Thread::yield();
+                }
+            }
+        }
+
+        std::function<void()> callback;
+        double blockMs;
+        int numBlocks;
+        double worstMs = 0.0;
+        int numOverruns = 0;
+    };
+
+    auto blockMs = 1000.0 * blockSize / sampleRate;
+
+    // This thread plays a message thread that is busy for 20 ms at a time, with short breaks
+    auto run = [blockMs, numBlocks] (std::function<void()> callback, std::function<void()> busyWork)
+    {
+        FakeAudioThread audioThread (std::move (callback), blockMs, numBlocks);
+        audioThread.startThread (juce::Thread::realtimeAudioPriority);
+        while (audioThread.isThreadRunning())
+        {
+            busyWork();
+            juce::Thread::sleep (5);
+        }
+
+        return "worst callback " + juce::String (audioThread.worstMs, 3) + " ms, "
+               + juce::String (audioThread.numOverruns) + " overruns";
+    };
+
+    juce::String report ("AudioEventQueue: " + juce::String (numBlocks) + " blocks of " + juce::String (blockSize)
+                         + " samples (" + juce::String (blockMs, 3) + " ms)");
+
+    juce::CriticalSection uiLock;
+    report << "\n  waiting on the UI: "
+           << run ([&uiLock] { const juce::ScopedLock sl (uiLock); },
+                   [&uiLock] { const juce::ScopedLock sl (uiLock); juce::Thread::sleep (20); });
+
+    AudioEventQueue queue;
+    auto numReceived = 0;
+    queue.setHandler ([&numReceived] (const Event&) { ++numReceived; });
+    report << "\n  posting to the queue: "
+           << run ([&queue] { queue.post (Event::Type::ticked); },
+                   [&queue] { juce::Thread::sleep (20); queue.drain(); });
+
+    queue.drain();
+    report << ", " << numReceived << " events received, " << queue.getNumDropped() << " dropped";
+    return report;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    AudioEventQueue.h
+    Created: 18 Oct 2026 10:37:26pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Set this to 1 in the Projucer preprocessor definitions to log, at startup,
+// how the audio callback copes with a busy message thread with and without the queue
+#ifndef DUBLOOPER_STRESS_TEST
+ #define DUBLOOPER_STRESS_TEST 0
+#endif
+
+// Carries events from the audio thread to the message thread without locks.
+// The audio thread never waits for the UI, and a timer on the message thread
+// hands the events to the handler.
+//
+// There are two ways to post. post() queues every event in a fixed-size FIFO,
+// in order, and drops them once the FIFO is full. postLatest() keeps only the
+// newest value of each type in an atomic, so it can never fill up. Use it for
+// progress that only matters as of now, and for events that must not be lost.
+class AudioEventQueue : private juce::Timer
+{
+public:
+    struct Event
+    {
+        // postLatest() events are handed over in this order
+        enum class Type
+        {
+            ticked,
+            recordingProgressed,
+            playingEnded,
+            recordingEnded
+        };
+
+        Type type;
+        int value;
+    };
+
+    using Handler = std::function<void (const Event&)>;
+
+    explicit AudioEventQueue (int capacity = 256);
+
+    // Message thread. Called for every event when the queue is drained.
+    void setHandler (Handler handler)
+    {
+        this->handler = std::move (handler);
+    }
+
+    // Audio thread. Never blocks or allocates. Drops the event and returns false if the queue is full.
+    bool post (Event::Type type, int value = 0);
+
+    // Audio thread. Never blocks, allocates or drops. If the same type is posted
+    // again before the next drain, the handler only gets the newest value.
+    void postLatest (Event::Type type, int value = 0);
+
+    // Message thread. Hands every waiting event to the handler and returns how many there were.
+    // The postLatest() events go first, then the queued ones. The timer calls this 60 times a second.
+    int drain();
+
+    int getNumDropped() const
+    {
+        return numDropped.get();
+    }
+
+    // Runs a fake audio callback in real time while this thread keeps busy,
+    // first waiting on a lock the way MessageManagerLock did, then posting to a queue.
+    static juce::String runStressTest (double sampleRate, int blockSize, int numBlocks);
+
+private:
+    void timerCallback() override
+    {
+        drain();
+    }
+
+    static constexpr int numTypes = 4;
+
+    juce::AbstractFifo fifo;
+    juce::HeapBlock<Event> events;
+    juce::Atomic<int> latestValues[numTypes];
+    juce::Atomic<bool> hasLatest[numTypes];
+    juce::Atomic<int> numDropped { 0 };
+    Handler handler;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioEventQueue)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    LoopFileWriter.cpp
+    Created: 19 Oct 2026 12:18:45am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "LoopFileWriter.h"
+
+LoopFileWriter::LoopFileWriter()
+    : takeFile (juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                    .getChildFile ("DubLooper Take.wav"))
+{
+    writerThread.startThread();
+}
+
+LoopFileWriter::~LoopFileWriter()
+{
+    discardTake();
+    savePool.removeAllJobs (false, 10000);
+    writerThread.stopThread (2000);
+}
+
+bool LoopFileWriter::startTake (int numChannels, double sampleRate)
+{
+    discardTake();
+
+    // An output stream would add to the end of an old take
+    takeFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream (takeFile.createOutputStream());
+    if (stream == nullptr)
+    {
+        return false;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer (format.createWriterFor (stream.get(), sampleRate, (unsigned int) numChannels, 24, {}, 0));
+    if (writer == nullptr)
+    {
+        return false;
+    }
+    stream.release();
+
+    // About a second of audio can wait for the disk before the take is given up on
+    take.reset (new juce::AudioFormatWriter::ThreadedWriter (writer.release(), writerThread, 1 << 16));
+    hasOverrun.set (false);
+    activeTake.set (take.get());
+    return true;
+}
+
+void LoopFileWriter::writeToTake (const PagedBuffer& loop, int index, int numSamples)
+{
+    auto* threadedWriter = activeTake.get();
+    if (threadedWriter == nullptr || hasOverrun.get())
+    {
+        return;
+    }
+
+    loop.forEachBlock (index, numSamples, [this, threadedWriter] (const juce::AudioBuffer<float>& block, int)
+    {
+        if (! hasOverrun.get() && ! threadedWriter->write (block.getArrayOfReadPointers(), block.getNumSamples()))
+        {
+            hasOverrun.set (true);
+        }
+    });
+}
+
+void LoopFileWriter::finishTake (bool coversLoop)
+{
+    if (take == nullptr)
+    {
+        return;
+    }
+
+    // Deleting the writer flushes what is still queued and closes the file
+    activeTake.set (nullptr);
+    take.reset();
+
+    hasKeptTake = coversLoop && ! hasOverrun.get();
+    if (! hasKeptTake)
+    {
+        takeFile.deleteFile();
+    }
+}
+
+void LoopFileWriter::discardTake()
+{
+    finishTake (false);
+    hasKeptTake = false;
+}
+
+void LoopFileWriter::save (const juce::File& file, const juce::ReferenceCountedArray<CachedSample>& layers,
+                           int numChannels, int numSamples, double sampleRate)
+{
+    if (hasKeptTake)
+    {
+        hasKeptTake = false;
+        if (takeFile.moveFileTo (file))
+        {
+            return;
+        }
+    }
+
+    savePool.addJob ([file, layers, numChannels, numSamples, sampleRate]
+    {
+        writeLayers (file, layers, numChannels, numSamples, sampleRate);
+    });
+}
+
+bool LoopFileWriter::writeLayers (const juce::File& file, const juce::ReferenceCountedArray<CachedSample>& layers,
+                                  int numChannels, int numSamples, double sampleRate)
+{
+    // Written next to the file first, so a save that fails halfway leaves the old one alone
+    juce::TemporaryFile temporaryFile (file);
+    std::unique_ptr<juce::FileOutputStream> stream (temporaryFile.getFile().createOutputStream());
+    if (stream == nullptr || numChannels == 0)
+    {
+        return false;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer (format.createWriterFor (stream.get(), sampleRate, (unsigned int) numChannels, 24, {}, 0));
+    if (writer == nullptr)
+    {
+        return false;
+    }
+    stream.release();
+
+    // The layers never change, so they can be mixed again here a block at a time
+    juce::AudioBuffer<float> block (numChannels, LoopMemoryPool::pageSize);
+    for (auto index = 0; index < numSamples; index += LoopMemoryPool::pageSize)
+    {
+        auto num = juce::jmin ((int) LoopMemoryPool::pageSize, numSamples - index);
+        block.clear();
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+        {
+            for (auto* layer : layers)
+            {
+                LoopLayers::addLayer (*layer, channel, index, block.getWritePointer (channel), num, 1.0f);
+            }
+        }
+
+        if (! writer->writeFromAudioSampleBuffer (block, 0, num))
+        {
+            return false;
+        }
+    }
+
+    writer.reset();
+    return temporaryFile.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    LoopFileWriter.h
+    Created: 19 Oct 2026 12:18:45am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "LoopLayers.h"
+
+// Saves the loop without blocking the message thread. It can also stream each
+// pass to a take file while it is recorded, through a bounded FIFO that a
+// background thread empties to disk. A take that covered the whole loop holds
+// the loop exactly, so saving it afterwards is just a rename.
+class LoopFileWriter
+{
+public:
+    LoopFileWriter();
+    ~LoopFileWriter();
+
+    // Message thread, before a pass starts. Opens a new take file for the pass to stream into.
+    bool startTake (int numChannels, double sampleRate);
+
+    // Audio thread. Queues numSamples of the loop from index for the writer
+    // thread. Never blocks: if the FIFO is full the take is spoiled instead.
+    void writeToTake (const PagedBuffer& loop, int index, int numSamples);
+
+    // Message thread, once the pass has stopped. The take is kept only if the
+    // pass covered the whole loop and nothing was dropped.
+    void finishTake (bool coversLoop);
+
+    // Message thread. The loop has changed some other way, so the take no longer matches it.
+    void discardTake();
+
+    // Message thread. Returns straight away. Moves a kept take to file, or adds
+    // up the layers and writes them there on a background thread.
+    void save (const juce::File& file, const juce::ReferenceCountedArray<CachedSample>& layers,
+               int numChannels, int numSamples, double sampleRate);
+
+    bool isSaving() const
+    {
+        return savePool.getNumJobs() > 0;
+    }
+
+private:
+    static bool writeLayers (const juce::File& file, const juce::ReferenceCountedArray<CachedSample>& layers,
+                             int numChannels, int numSamples, double sampleRate);
+
+    juce::TimeSliceThread writerThread { "DubLooper Take Writer" };
+    juce::ThreadPool savePool { 1 };
+
+    // The audio thread only sees the take through activeTake, between startTake and finishTake
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> take;
+    juce::Atomic<juce::AudioFormatWriter::ThreadedWriter*> activeTake { nullptr };
+    juce::Atomic<bool> hasOverrun { false };
+
+    juce::File takeFile;
+    bool hasKeptTake = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopFileWriter)
+};
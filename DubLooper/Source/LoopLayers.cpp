@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    LoopLayers.cpp
+    Created: 18 Oct 2026 7:41:52pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "LoopLayers.h"
+
+void LoopLayers::prepare (double sampleRate)
+{
+    auto capacity = (int) std::ceil (sampleRate * maxLoopSeconds);
+    if (capacity <= mixdown.getCapacity())
+    {
+        return;
+    }
+
+    // Audio isn't running yet, so the layers can be put back into the new pages
+    // before the lock is released
+    const juce::SpinLock::ScopedLockType sl (lock);
+    mixdown.release (pool);
+    spareMixdown.release (pool);
+    recording.release (pool);
+    mixdown.allocate (pool, maxChannels, capacity);
+    spareMixdown.allocate (pool, maxChannels, capacity);
+    recording.allocate (pool, maxChannels, capacity);
+    hasUncommittedLayer.set (false);
+
+    buildMixdown();
+    mixdown.swapWith (spareMixdown);
+}
+
+bool LoopLayers::startLayer (int numChannels, int numSamples)
+{
+    // The caller tries again on the next block
+    const juce::SpinLock::ScopedTryLockType sl (lock);
+    if (! sl.isLocked() || hasUncommittedLayer.get())
+    {
+        return false;
+    }
+
+    // An empty loop takes the size of its first pass, later passes take the
+    // loop's size. The mixdown's pages are silenced whenever it is emptied.
+    if (mixdown.getNumSamples() == 0)
+    {
+        mixdown.setSize (numChannels, numSamples);
+    }
+
+    // Only what gets recorded is read back, so the pages don't need clearing
+    recording.setSize (mixdown.getNumChannels(), mixdown.getNumSamples());
+    recordedLength = 0;
+    hasUncommittedLayer.set (true);
+    return true;
+}
+
+void LoopLayers::overdub (juce::AudioBuffer<float>& buffer, int startSample, int position, int numSamples)
+{
+    for (auto channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getWritePointer (channel, startSample);
+
+        if (channel >= mixdown.getNumChannels())
+        {
+            juce::FloatVectorOperations::clear (data, numSamples);
+            continue;
+        }
+
+        // Keep the input, play the loop as it was, then add the input to it for the
+        // next pass. Both buffers split into pages at the same places.
+        for (auto done = 0; done < numSamples;)
+        {
+            auto run = PagedBuffer::getNumContiguous (position + done, numSamples - done);
+            auto* layer = recording.getPointer (channel, position + done);
+            auto* loop = mixdown.getPointer (channel, position + done);
+
+            juce::FloatVectorOperations::copy (layer, data + done, run);
+            juce::FloatVectorOperations::copy (data + done, loop, run);
+            juce::FloatVectorOperations::add (loop, layer, run);
+            done += run;
+        }
+    }
+
+    recordedLength = juce::jmax (recordedLength, position + numSamples);
+}
+
+bool LoopLayers::commitLayer (double sampleRate)
+{
+    if (! hasUncommittedLayer.get())
+    {
+        return false;
+    }
+
+    juce::AudioBuffer<float> recorded;
+    {
+        // Waits for the block that may still be recording into it. After that the
+        // audio thread leaves the pages alone until the next pass starts.
+        const juce::SpinLock::ScopedLockType sl (lock);
+        recording.setSize (recording.getNumChannels(), recordedLength);
+    }
+    auto coversLoop = recordedLength >= mixdown.getNumSamples();
+    recording.copyTo (recorded);
+    recorded.setSize (mixdown.getNumChannels(), mixdown.getNumSamples(), true, true);
+    hasUncommittedLayer.set (false);
+
+    // Only the newest layer is kept at full precision
+    if (auto previous = layers.getLast())
+    {
+        if (! previous->isCompact())
+        {
+            layers.set (layers.size() - 1, previous->createCopy (true));
+        }
+    }
+
+    layers.add (new CachedSample ("DubLooper Layer", std::move (recorded), sampleRate, false));
+    undoneLayers.clear();
+    return coversLoop;
+}
+
+bool LoopLayers::undo()
+{
+    if (hasUncommittedLayer.get() || layers.isEmpty())
+    {
+        return false;
+    }
+
+    CachedSample::Ptr layer (layers.getLast());
+    layers.removeLast();
+    buildMixdown();
+
+    if (! swapMixdown (false))
+    {
+        layers.add (layer.get());
+        return false;
+    }
+
+    undoneLayers.add (layer.get());
+    return true;
+}
+
+bool LoopLayers::redo()
+{
+    if (hasUncommittedLayer.get() || undoneLayers.isEmpty())
+    {
+        return false;
+    }
+
+    CachedSample::Ptr layer (undoneLayers.getLast());
+    layers.add (layer.get());
+    buildMixdown();
+
+    if (! swapMixdown (false))
+    {
+        layers.removeLast();
+        return false;
+    }
+
+    undoneLayers.removeLast();
+    return true;
+}
+
+void LoopLayers::load (juce::AudioBuffer<float>&& buffer, double sampleRate)
+{
+    // A loop read before the device has started is kept at its own rate's size
+    prepare (sampleRate);
+    buffer.setSize (juce::jmin (buffer.getNumChannels(), maxChannels),
+                    juce::jmin (buffer.getNumSamples(), mixdown.getCapacity()), true);
+
+    layers.clear();
+    undoneLayers.clear();
+    layers.add (new CachedSample ("DubLooper Layer", std::move (buffer), sampleRate, false));
+
+    buildMixdown();
+    swapMixdown (true);
+}
+
+void LoopLayers::clear()
+{
+    layers.clear();
+    undoneLayers.clear();
+
+    // The pages stay reserved for the next loop
+    buildMixdown();
+    swapMixdown (true);
+}
+
+void LoopLayers::buildMixdown()
+{
+    // The audio thread never touches the spare pages. Silence all of them, since
+    // an empty loop takes whatever size its first pass gives it.
+    spareMixdown.setSize (maxChannels, spareMixdown.getCapacity());
+    spareMixdown.clear();
+    spareMixdown.setSize (0, 0);
+
+    // With no layers left the loop is silent, and the next pass may set a new size
+    if (auto first = layers.getFirst())
+    {
+        spareMixdown.setSize (first->getNumChannels(), first->getNumSamples());
+        for (auto* layer : layers)
+        {
+            mix (spareMixdown, *layer);
+        }
+    }
+}
+
+bool LoopLayers::swapMixdown (bool dropPass)
+{
+    // Only ever held for the swap itself
+    const juce::SpinLock::ScopedLockType sl (lock);
+    if (hasUncommittedLayer.get())
+    {
+        if (! dropPass)
+        {
+            return false;
+        }
+
+        recording.setSize (0, 0);
+        hasUncommittedLayer.set (false);
+    }
+
+    mixdown.swapWith (spareMixdown);
+    return true;
+}
+
+void LoopLayers::mix (PagedBuffer& dest, const CachedSample& layer)
+{
+    auto numSamples = juce::jmin (dest.getNumSamples(), layer.getNumSamples());
+
+    // Runs never cross a page
+    for (auto channel = 0; channel < dest.getNumChannels(); ++channel)
+    {
+        for (auto done = 0; done < numSamples;)
+        {
+            auto run = PagedBuffer::getNumContiguous (done, numSamples - done);
+            addLayer (layer, channel, done, dest.getPointer (channel, done), run, 1.0f);
+            done += run;
+        }
+    }
+}
+
+void LoopLayers::addLayer (const CachedSample& layer, int channel, int index, float* dest, int numSamples, float gain)
+{
+    numSamples = juce::jmin (numSamples, layer.getNumSamples() - index);
+    if (channel >= layer.getNumChannels() || numSamples <= 0)
+    {
+        return;
+    }
+
+    if (! layer.isCompact())
+    {
+        juce::FloatVectorOperations::addWithMultiply (dest, layer.getBuffer().getReadPointer (channel, index), gain, numSamples);
+        return;
+    }
+
+    float expanded[256];
+    for (auto done = 0; done < numSamples; done += 256)
+    {
+        auto num = juce::jmin (256, numSamples - done);
+        CachedSample::expand (layer.getCompactData (channel) + index + done, expanded, layer.getCompactScale(), num);
+        juce::FloatVectorOperations::addWithMultiply (dest + done, expanded, gain, num);
+    }
+}
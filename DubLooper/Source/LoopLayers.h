@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    LoopLayers.h
+    Created: 18 Oct 2026 7:41:52pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SampleCache.h"
+#include "LoopMemoryPool.h"
+
+// The passes recorded over one loop, kept as separate layers so they can be
+// undone and redone. Playback reads a running mixdown that each pass is added
+// to as it is recorded, so it costs the same however many layers there are.
+//
+// The newest layer stays in floats and older layers are kept as 16-bit compact
+// samples, which halves their memory. Undo and redo rebuild the mixdown from
+// the layers rather than adding and subtracting them, so no error builds up,
+// but a rebuilt loop plays its older layers at 16-bit rather than exactly as
+// they were recorded.
+//
+// The mixdown, a spare mixdown and the pass being recorded live in pages
+// reserved by prepare(), so starting a pass on the audio thread allocates
+// nothing. A new mixdown is built in the spare pages without the lock and then
+// swapped in, so the audio thread is never kept waiting for longer than a swap.
+class LoopLayers
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr double maxLoopSeconds = 30.0;
+
+    LoopLayers() {}
+
+    // Message thread, before audio starts. Reserves room for the longest loop at
+    // sampleRate. If that needs more pages, the mixdown is rebuilt in them from the layers.
+    void prepare (double sampleRate);
+
+    // The audio thread try-locks this for each block and skips the block if it
+    // can't. The message thread only holds it for constant-time changes, such as
+    // swapping in a new mixdown, except in prepare() before audio starts.
+    juce::SpinLock& getLock()
+    {
+        return lock;
+    }
+
+    // Audio thread, holding the lock. The sum of every layer that hasn't been undone.
+    const PagedBuffer& getMixdown() const
+    {
+        return mixdown;
+    }
+
+    int getNumSamples() const
+    {
+        return mixdown.getNumSamples();
+    }
+
+    // Audio thread. Starts recording a pass over the loop. The first pass sets the
+    // loop's size, up to maxLoopSeconds. Fails until the previous pass is committed,
+    // or if the message thread holds the lock. Takes constant time and never allocates.
+    bool startLayer (int numChannels, int numSamples);
+
+    // Audio thread, holding the lock. Records numSamples of buffer at position in
+    // the loop, and replaces them with what the loop played there before this pass.
+    void overdub (juce::AudioBuffer<float>& buffer, int startSample, int position, int numSamples);
+
+    // Message thread, once a pass has stopped. Keeps it as the newest layer and
+    // compresses the layer before it. Returns true if the pass covered the whole loop.
+    bool commitLayer (double sampleRate);
+
+    // Message thread. Both fail while a pass is being recorded, including one
+    // that started while the new mixdown was being built.
+    bool undo();
+    bool redo();
+
+    bool canUndo() const
+    {
+        return ! layers.isEmpty();
+    }
+
+    bool canRedo() const
+    {
+        return ! undoneLayers.isEmpty();
+    }
+
+    int getNumLayers() const
+    {
+        return layers.size();
+    }
+
+    // Message thread. The layers never change once committed, so any thread may read these.
+    juce::ReferenceCountedArray<CachedSample> getLayers() const
+    {
+        return layers;
+    }
+
+    // Adds numSamples of a layer's channel from index to dest times gain.
+    // Compact layers are expanded a chunk at a time on the stack.
+    static void addLayer (const CachedSample& layer, int channel, int index, float* dest, int numSamples, float gain);
+
+    // Message thread. Replaces the loop with a single layer, cut to maxLoopSeconds.
+    void load (juce::AudioBuffer<float>&& buffer, double sampleRate);
+
+    // Message thread. Forgets every layer.
+    void clear();
+
+private:
+    // Builds the sum of the layers in spareMixdown. Doesn't take the lock.
+    void buildMixdown();
+
+    // Swaps spareMixdown in for the mixdown. A pass being recorded either stops
+    // the swap or, with dropPass, is thrown away.
+    bool swapMixdown (bool dropPass);
+
+    // Adds a layer to dest
+    static void mix (PagedBuffer& dest, const CachedSample& layer);
+
+    juce::SpinLock lock;
+    LoopMemoryPool pool;
+    PagedBuffer mixdown;
+    PagedBuffer spareMixdown;
+    PagedBuffer recording;
+    juce::Atomic<bool> hasUncommittedLayer { false };
+
+    // How far the pass being recorded got. Only touched with the lock held.
+    int recordedLength = 0;
+
+    // Only touched on the message thread. The last layer is the newest.
+    juce::ReferenceCountedArray<CachedSample> layers;
+    juce::ReferenceCountedArray<CachedSample> undoneLayers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopLayers)
+};
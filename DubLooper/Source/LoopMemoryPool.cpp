@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    LoopMemoryPool.cpp
+    Created: 18 Oct 2026 9:05:17pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "LoopMemoryPool.h"
+
+void LoopMemoryPool::reserve (int numPagesNeeded)
+{
+    while (numPages < numPagesNeeded)
+    {
+        auto* chunk = chunks.add (new juce::HeapBlock<float> ((size_t) pagesPerChunk * (size_t) pageSize, true));
+
+        for (auto page = 0; page < pagesPerChunk; ++page)
+        {
+            freePages.add (chunk->get() + (size_t) page * (size_t) pageSize);
+        }
+        numPages += pagesPerChunk;
+    }
+}
+
+float* LoopMemoryPool::takePage()
+{
+    return freePages.isEmpty() ? nullptr : freePages.removeAndReturn (freePages.size() - 1);
+}
+
+void LoopMemoryPool::returnPage (float* page)
+{
+    freePages.add (page);
+}
+
+bool PagedBuffer::allocate (LoopMemoryPool& pool, int numChannelsToHold, int samplesToHold)
+{
+    release (pool);
+
+    auto pagesPerChannel = LoopMemoryPool::getNumPagesFor (samplesToHold);
+    pool.reserve (pool.getNumPages() - pool.getNumFreePages() + numChannelsToHold * pagesPerChannel);
+    pages.ensureStorageAllocated (numChannelsToHold * pagesPerChannel);
+
+    for (auto i = 0; i < numChannelsToHold * pagesPerChannel; ++i)
+    {
+        auto* page = pool.takePage();
+        if (page == nullptr)
+        {
+            release (pool);
+            return false;
+        }
+        pages.add (page);
+    }
+
+    maxChannels = numChannelsToHold;
+    numPagesPerChannel = pagesPerChannel;
+    capacity = pagesPerChannel * LoopMemoryPool::pageSize;
+    numChannels = 0;
+    numSamples = 0;
+    return true;
+}
+
+void PagedBuffer::release (LoopMemoryPool& pool)
+{
+    for (auto* page : pages)
+    {
+        pool.returnPage (page);
+    }
+    pages.clear();
+
+    maxChannels = 0;
+    numPagesPerChannel = 0;
+    capacity = 0;
+    numChannels = 0;
+    numSamples = 0;
+}
+
+void PagedBuffer::clear()
+{
+    for (auto channel = 0; channel < numChannels; ++channel)
+    {
+        for (auto index = 0; index < numSamples; index += LoopMemoryPool::pageSize)
+        {
+            juce::FloatVectorOperations::clear (getPointer (channel, index), getNumContiguous (index, numSamples - index));
+        }
+    }
+}
+
+void PagedBuffer::swapWith (PagedBuffer& other) noexcept
+{
+    pages.swapWith (other.pages);
+    std::swap (maxChannels, other.maxChannels);
+    std::swap (numPagesPerChannel, other.numPagesPerChannel);
+    std::swap (capacity, other.capacity);
+    std::swap (numChannels, other.numChannels);
+    std::swap (numSamples, other.numSamples);
+}
+
+void PagedBuffer::addTo (float* dest, int channel, int index, int num) const
+{
+    for (auto done = 0; done < num;)
+    {
+        auto run = getNumContiguous (index + done, num - done);
+        juce::FloatVectorOperations::add (dest + done, getPointer (channel, index + done), run);
+        done += run;
+    }
+}
+
+void PagedBuffer::copyTo (juce::AudioBuffer<float>& dest) const
+{
+    dest.setSize (numChannels, numSamples);
+
+    for (auto channel = 0; channel < numChannels; ++channel)
+    {
+        for (auto index = 0; index < numSamples; index += LoopMemoryPool::pageSize)
+        {
+            juce::FloatVectorOperations::copy (dest.getWritePointer (channel, index), getPointer (channel, index),
+                                               getNumContiguous (index, numSamples - index));
+        }
+    }
+}
+
+void PagedBuffer::copyFrom (const juce::AudioBuffer<float>& source)
+{
+    setSize (source.getNumChannels(), source.getNumSamples());
+
+    for (auto channel = 0; channel < numChannels; ++channel)
+    {
+        for (auto index = 0; index < numSamples; index += LoopMemoryPool::pageSize)
+        {
+            juce::FloatVectorOperations::copy (getPointer (channel, index), source.getReadPointer (channel, index),
+                                               getNumContiguous (index, numSamples - index));
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    LoopMemoryPool.h
+    Created: 18 Oct 2026 9:05:17pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Loop memory reserved before audio starts, handed out in fixed-size pages.
+// Pages are allocated a chunk at a time, so even a long loop never needs one
+// huge contiguous block. Only the message thread takes and returns pages.
+class LoopMemoryPool
+{
+public:
+    static constexpr int pageSize = 4096;
+
+    LoopMemoryPool() {}
+
+    // Makes sure at least numPages pages exist. Existing pages stay where they are.
+    void reserve (int numPages);
+
+    // nullptr once every page is in use
+    float* takePage();
+    void returnPage (float* page);
+
+    int getNumPages() const
+    {
+        return numPages;
+    }
+
+    int getNumFreePages() const
+    {
+        return freePages.size();
+    }
+
+    static int getNumPagesFor (int numSamples)
+    {
+        return (numSamples + pageSize - 1) / pageSize;
+    }
+
+private:
+    static constexpr int pagesPerChunk = 64;
+
+    juce::OwnedArray<juce::HeapBlock<float>> chunks;
+    juce::Array<float*> freePages;
+    int numPages = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopMemoryPool)
+};
+
+// Audio held in pages from a LoopMemoryPool, with room for up to its capacity
+// on every channel. Changing its size never allocates, so it can grow and
+// shrink on the audio thread.
+class PagedBuffer
+{
+public:
+    PagedBuffer() {}
+
+    // Message thread. Takes the pages for numChannels x capacity samples, and fails if the pool runs out.
+    bool allocate (LoopMemoryPool& pool, int numChannels, int capacity);
+    void release (LoopMemoryPool& pool);
+
+    // Only the first numSamples of the first numChannels are part of the buffer
+    void setSize (int numChannels, int numSamples)
+    {
+        this->numChannels = juce::jmin (numChannels, maxChannels);
+        this->numSamples = juce::jmin (numSamples, capacity);
+    }
+
+    // Silences the part in use
+    void clear();
+
+    // Trades pages and sizes with other in constant time, without allocating
+    void swapWith (PagedBuffer& other) noexcept;
+
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    int getNumSamples() const
+    {
+        return numSamples;
+    }
+
+    int getCapacity() const
+    {
+        return capacity;
+    }
+
+    // Where sample index of channel is. Only getNumContiguous samples from there share its page.
+    float* getPointer (int channel, int index) const
+    {
+        return pages.getUnchecked (channel * numPagesPerChannel + index / LoopMemoryPool::pageSize)
+                 + index % LoopMemoryPool::pageSize;
+    }
+
+    static int getNumContiguous (int index, int numSamples)
+    {
+        return juce::jmin (numSamples, LoopMemoryPool::pageSize - index % LoopMemoryPool::pageSize);
+    }
+
+    // Adds numSamples of channel from index to dest, a page at a time
+    void addTo (float* dest, int channel, int index, int numSamples) const;
+
+    // Read-only access without copying. Calls function (block, index) for each
+    // run of numSamples from index that shares a page, with an AudioBuffer that
+    // refers straight to the pages.
+    template <typename Function>
+    void forEachBlock (int index, int numSamples, Function&& function) const
+    {
+        jassert (numChannels <= maxViewChannels);
+        float* channels[maxViewChannels] = {};
+
+        for (auto done = 0; done < numSamples;)
+        {
+            auto run = getNumContiguous (index + done, numSamples - done);
+            for (auto channel = 0; channel < numChannels; ++channel)
+            {
+                channels[channel] = getPointer (channel, index + done);
+            }
+
+            const juce::AudioBuffer<float> block (channels, numChannels, run);
+            function (block, index + done);
+            done += run;
+        }
+    }
+
+    // Message thread. Resizes dest and copies the part in use into it.
+    void copyTo (juce::AudioBuffer<float>& dest) const;
+
+    // Takes the size of source, up to the capacity, and copies it in
+    void copyFrom (const juce::AudioBuffer<float>& source);
+
+private:
+    static constexpr int maxViewChannels = 8;
+
+    juce::Array<float*> pages;
+    int maxChannels = 0;
+    int numPagesPerChannel = 0;
+    int capacity = 0;
+    int numChannels = 0;
+    int numSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PagedBuffer)
+};
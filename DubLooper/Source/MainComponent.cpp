@@ -39,19 +39,30 @@ MainComponent::MainComponent()
 
     sampleBuffer.setListener (this);
     sampleBuffer.enableLoop (true);
+    sampleBuffer.setStreamToDisk (DUBLOOPER_STREAM_TO_DISK != 0);
     metronome.setListener (this);
+    audioEvents.setHandler ([this] (const AudioEventQueue::Event& event) { handleAudioEvent (event); });
 
     saveButton.setButtonText ("Save");
     saveButton.onClick = [this] { sampleBuffer.write ("DubLooper.wav"); };
 
+    // Each recording over the loop is a layer that can be taken back
+    undoButton.setButtonText ("Undo");
+    undoButton.onClick = [this] { if (sampleBuffer.undo()) updateLoopView(); };
+    redoButton.setButtonText ("Redo");
+    redoButton.onClick = [this] { if (sampleBuffer.redo()) updateLoopView(); };
+
     // read audio file if it exists
     sampleBuffer.read ("DubLooper.wav");
 
     // Initialize the thumbnail
     formatManager.registerBasicFormats();
     thumbnail.addChangeListener (this);
-    thumbnail.reset(1, 44100, sampleBuffer.getNumSamples());
-    thumbnail.addBlock(0, sampleBuffer.getBuffer(), 0, sampleBuffer.getNumSamples());
+    updateLoopView();
+
+   #if DUBLOOPER_STRESS_TEST
+    juce::Logger::writeToLog (AudioEventQueue::runStressTest (48000.0, 64, 4000));
+   #endif
 }
 
 MainComponent::~MainComponent()
@@ -64,6 +75,7 @@ MainComponent::~MainComponent()
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
     metronome.prepareToPlay (sampleRate);
+    sampleBuffer.prepareToPlay (sampleRate);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -79,15 +91,9 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     {
         sampleBuffer.record(2, metronome.getInterval() * 16);
     }
-    // Recording and Playback
+    // Recording and Playback. While recording, the input is replaced with the loop underneath.
     sampleBuffer.getNextAudioBlock (bufferToFill);
 
-    // Clear buffer when recording is happening to avoid feedback
-    if (sampleBuffer.getIsRecording())
-    {
-        bufferToFill.clearActiveBufferRegion();
-    }
-
     // Playback
     metronome.tick (bufferToFill.numSamples);
     metronome.getNextAudioBlock (bufferToFill);
@@ -111,6 +117,10 @@ void MainComponent::paint (juce::Graphics& g)
     recordButton.setBounds (getWidth() / 2 - 50, getHeight() - 100, 100, 50);
     addAndMakeVisible (saveButton);
     saveButton.setBounds (getWidth() - 110, getHeight() - 100, 100, 50);
+    addAndMakeVisible (undoButton);
+    undoButton.setBounds (10, 100, 100, 50);
+    addAndMakeVisible (redoButton);
+    redoButton.setBounds (120, 100, 100, 50);
 
     addAndMakeVisible (countLabel);
     countLabel.setBounds (getWidth() / 2 - 50, getHeight() - 150, 100, 50);
@@ -161,14 +171,19 @@ void MainComponent::buttonClicked (juce::Button* button)
         {
             metronome.stop();
             sampleBuffer.stopRecording();
+            sampleBuffer.commitRecording();
             recordButton.setButtonText("Record");
             playButton.setEnabled (true);
+            updateLoopView();
         }
         else
         {
+            sampleBuffer.armRecording();
             metronome.start();
             recordButton.setButtonText("Stop");
             playButton.setEnabled (false);
+            undoButton.setEnabled (false);
+            redoButton.setEnabled (false);
             if (sampleBuffer.getIsPlaying())
             {
                 sampleBuffer.stopPlaying();
@@ -180,27 +195,87 @@ void MainComponent::buttonClicked (juce::Button* button)
 
 void MainComponent::playingEnded()
 {
-    const juce::MessageManagerLock mmLock;
-    playButton.setButtonText("Play");
+    audioEvents.postLatest (AudioEventQueue::Event::Type::playingEnded);
 }
 
 void MainComponent::recordingEnded()
 {
+    // The metronome runs on the audio thread, so it stops here straight away
     metronome.stop();
+    audioEvents.postLatest (AudioEventQueue::Event::Type::recordingEnded);
+}
 
-    const juce::MessageManagerLock mmLock;
-    recordButton.setButtonText("Record");
-    playButton.setEnabled (true);
-
-    // Update thumbnail
-    thumbnail.reset(1, 44100, sampleBuffer.getNumSamples());
-    thumbnail.addBlock(0, sampleBuffer.getBuffer(), 0, sampleBuffer.getNumSamples());
+void MainComponent::recordingProgressed (int numSamplesRecorded)
+{
+    // Posted every block, so only the newest count is kept rather than filling the queue
+    audioEvents.postLatest (AudioEventQueue::Event::Type::recordingProgressed, numSamplesRecorded);
 }
 
 void MainComponent::ticked()
 {
-    const juce::MessageManagerLock mmLock;
-    repaint();
+    audioEvents.post (AudioEventQueue::Event::Type::ticked, metronome.getCurrentBeat());
+}
+
+void MainComponent::handleAudioEvent (const AudioEventQueue::Event& event)
+{
+    switch (event.type)
+    {
+        case AudioEventQueue::Event::Type::ticked:
+            repaint();
+            break;
+
+        case AudioEventQueue::Event::Type::playingEnded:
+            playButton.setButtonText("Play");
+            break;
+
+        case AudioEventQueue::Event::Type::recordingEnded:
+            recordButton.setButtonText("Record");
+            playButton.setEnabled (true);
+
+            // A pass only ends once it has covered the loop. Draw whatever the last
+            // progress update missed, then keep the pass as a layer.
+            drawRecorded (sampleBuffer.getNumSamples());
+            sampleBuffer.commitRecording();
+            undoButton.setEnabled (sampleBuffer.canUndo());
+            redoButton.setEnabled (sampleBuffer.canRedo());
+            break;
+
+        case AudioEventQueue::Event::Type::recordingProgressed:
+            drawRecorded (event.value);
+            break;
+    }
+}
+
+void MainComponent::drawRecorded (int numSamplesRecorded)
+{
+    // A new pass draws over the loop from the start, and a new loop needs a thumbnail of its length
+    if (numSamplesRecorded < numSamplesDrawn)
+    {
+        numSamplesDrawn = 0;
+    }
+    if (sampleBuffer.getNumSamples() != thumbnailLength)
+    {
+        thumbnailLength = sampleBuffer.getNumSamples();
+        thumbnail.reset (1, sampleBuffer.getSampleRate(), thumbnailLength);
+    }
+
+    sampleBuffer.getLoop().forEachBlock (numSamplesDrawn, numSamplesRecorded - numSamplesDrawn,
+                                         [this] (const juce::AudioBuffer<float>& block, int index)
+                                         {
+                                             thumbnail.addBlock (index, block, 0, block.getNumSamples());
+                                         });
+    numSamplesDrawn = numSamplesRecorded;
+}
+
+void MainComponent::updateLoopView()
+{
+    thumbnailLength = sampleBuffer.getNumSamples();
+    numSamplesDrawn = 0;
+    thumbnail.reset (1, sampleBuffer.getSampleRate(), thumbnailLength);
+    drawRecorded (thumbnailLength);
+
+    undoButton.setEnabled (sampleBuffer.canUndo());
+    redoButton.setEnabled (sampleBuffer.canRedo());
 }
 
 void MainComponent::changeListenerCallback (juce::ChangeBroadcaster* source)
@@ -3,6 +3,13 @@
 #include <JuceHeader.h>
 #include "Metronome.h"
 #include "SampleBuffer.h"
+#include "AudioEventQueue.h"
+
+// Set this to 1 in the Projucer preprocessor definitions to stream every
+// recorded pass to disk while it is captured, so saving it is instant
+#ifndef DUBLOOPER_STREAM_TO_DISK
+ #define DUBLOOPER_STREAM_TO_DISK 0
+#endif
 
 //==============================================================================
 /*
@@ -31,9 +38,19 @@ public:
     void ticked() override;
     void playingEnded() override;
     void recordingEnded() override;
+    void recordingProgressed (int numSamplesRecorded) override;
     void changeListenerCallback (juce::ChangeBroadcaster* source) override;
 
 private:
+    // Redraws the waveform from the loop and enables undo/redo to match it
+    void updateLoopView();
+
+    // Draws the part of the loop recorded since the last call, straight from the loop's pages
+    void drawRecorded (int numSamplesRecorded);
+
+    // Message thread. Reacts to what the audio thread posted.
+    void handleAudioEvent (const AudioEventQueue::Event& event);
+
     //==============================================================================
     Metronome metronome;
     SampleBuffer sampleBuffer;
@@ -41,11 +58,18 @@ private:
     juce::TextButton recordButton;
     juce::TextButton playButton;
     juce::TextButton saveButton;
+    juce::TextButton undoButton;
+    juce::TextButton redoButton;
     juce::Label countLabel;
 
     juce::AudioFormatManager formatManager;
     juce::AudioThumbnailCache thumbnailCache {5};
     juce::AudioThumbnail thumbnail {512, formatManager, thumbnailCache};
+    int thumbnailLength = 0;
+    int numSamplesDrawn = 0;
+
+    // The audio thread tells the UI about ticks and endings through this, so it never waits for the UI
+    AudioEventQueue audioEvents;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -19,88 +19,141 @@
 
 void SampleBuffer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    if (isPlaying)
+    auto hasPlayingEnded = false;
+    auto hasRecordingEnded = false;
+    auto numRecorded = -1;
     {
-        auto numInputChannels = fileBuffer.getNumChannels();
-        auto numOutputChannels = bufferToFill.buffer->getNumChannels();
-        auto numSamples = bufferToFill.numSamples;
-
-        // Go through all the channels available
-        for (auto channel = 0; channel < numOutputChannels; ++channel)
+        // The message thread swaps in a new loop under this lock. Skip the block rather than
+        // wait, but keep the playhead moving so the loop stays in time.
+        const juce::SpinLock::ScopedTryLockType lock (loop.getLock());
+        if (! lock.isLocked())
         {
-            // % numInputChannels is to compensate when the audio buffer and the main audio
-            // system do not agree on the number of channels.
-            auto* channelDataIn = fileBuffer.getReadPointer (channel % numInputChannels);
-            auto* channelDataOut = bufferToFill.buffer->getWritePointer (channel);
-
-            // mix in sample by sample to the main buffer
-            for (auto sample = 0; sample < numSamples; ++sample)
+            if (isPlaying && playbackLength > 0)
             {
-                // if the reading position exceeds the size of buffer, break out of the loop
-                if (position + sample >= fileBuffer.getNumSamples()) break;
-                channelDataOut[sample] += channelDataIn[position + sample];
+                position = isLooping ? (position + bufferToFill.numSamples) % playbackLength
+                                     : juce::jmin (position + bufferToFill.numSamples, playbackLength);
             }
+            return;
         }
 
-        // Update the audio buffer reading position
-        position += numSamples;
-
-        // Stop the playback once the reading position reaches the size of buffer
-        if (position >= fileBuffer.getNumSamples())
+        if (isPlaying)
         {
-            if (!isLooping)
+            // Assets play from the shared cache, recorded and read loops from the loop's mixdown
+            const auto& mixdown = loop.getMixdown();
+            auto numInputChannels = sample != nullptr ? sample->getNumChannels() : mixdown.getNumChannels();
+            auto numOutputChannels = bufferToFill.buffer->getNumChannels();
+            auto numSamples = bufferToFill.numSamples;
+            auto length = sample != nullptr ? sample->getNumSamples() : mixdown.getNumSamples();
+            playbackLength = length;
+
+            if (numInputChannels == 0 || length == 0)
+            {
+                return;
+            }
+
+            // Go through all the channels available
+            for (auto channel = 0; channel < numOutputChannels; ++channel)
             {
-                isPlaying = false;
-                if(listener != nullptr)
+                // % numInputChannels is to compensate when the audio buffer and the main audio
+                // system do not agree on the number of channels.
+                auto channelIn = channel % numInputChannels;
+                auto* channelDataOut = bufferToFill.buffer->getWritePointer (channel, bufferToFill.startSample);
+
+                // Mix in whole runs that stop at the end of the buffer, wrapping around when looping
+                auto readPosition = position;
+                auto done = 0;
+                while (done < numSamples)
                 {
-                    listener->playingEnded();
+                    auto num = juce::jmin (numSamples - done, length - readPosition);
+                    if (sample != nullptr)
+                    {
+                        juce::FloatVectorOperations::add (channelDataOut + done, sample->getBuffer().getReadPointer (channelIn, readPosition), num);
+                    }
+                    else
+                    {
+                        mixdown.addTo (channelDataOut + done, channelIn, readPosition, num);
+                    }
+                    done += num;
+                    readPosition += num;
+
+                    if (readPosition >= length)
+                    {
+                        if (!isLooping) break;
+                        readPosition = 0;
+                    }
                 }
             }
-            else
+
+            // Update the audio buffer reading position
+            position += numSamples;
+
+            // Stop the playback once the reading position reaches the size of buffer
+            if (position >= length)
             {
-                position = 0;
+                if (!isLooping)
+                {
+                    isPlaying = false;
+                    hasPlayingEnded = true;
+                }
+                else
+                {
+                    position %= length;
+                }
             }
         }
-    }
-    else if (isRecording)
-    {
-        auto numOutputChannels = bufferToFill.buffer->getNumChannels();
-        auto numSamples = bufferToFill.numSamples;
-
-        // Go through all the channels available
-        for (auto channel = 0; channel < numOutputChannels; ++channel)
+        else if (isRecording)
         {
-            // system do not agree on the number of channels.
-            auto* channelDataIn = fileBuffer.getWritePointer (channel);
-            auto* channelDataOut = bufferToFill.buffer->getReadPointer (channel);
+            auto numSamples = bufferToFill.numSamples;
 
-            // mix in sample by sample to the main buffer
-            for (auto sample = 0; sample < numSamples; ++sample)
+            // Only as much as is left of the loop gets recorded. The input is replaced
+            // with the loop as it was, and anything past its end is silenced.
+            auto num = juce::jmax (0, juce::jmin (numSamples, loop.getNumSamples() - position));
+            loop.overdub (*bufferToFill.buffer, bufferToFill.startSample, position, num);
+            bufferToFill.buffer->clear (bufferToFill.startSample + num, numSamples - num);
+
+            // The loop as this pass leaves it goes to disk as it is recorded
+            if (streamToDisk)
             {
-                // if the reading position exceeds the size of buffer, break out of the loop
-                if (position + sample >= fileBuffer.getNumSamples()) break;
-                channelDataIn[position + sample] += channelDataOut[sample];
+                fileWriter->writeToTake (loop.getMixdown(), position, num);
             }
-        }
 
-        // Update the audio buffer writing position
-        position += numSamples;
+            // Update the audio buffer writing position
+            position += numSamples;
+            numRecorded = juce::jmin (position, loop.getNumSamples());
 
-        // Stop the recording once the reading position reaches the size of buffer
-        if (position >= fileBuffer.getNumSamples())
-        {
-            isRecording = false;
-            if(listener != nullptr)
+            // Stop the recording once the reading position reaches the size of buffer
+            if (position >= loop.getNumSamples())
             {
-                listener->recordingEnded();
+                isRecording = false;
+                hasRecordingEnded = true;
             }
         }
     }
+
+    // Listeners may change the loop, so they are told once the lock is released
+    if (listener != nullptr)
+    {
+        if (numRecorded >= 0)
+        {
+            listener->recordingProgressed (numRecorded);
+        }
+        if (hasPlayingEnded)
+        {
+            listener->playingEnded();
+        }
+        if (hasRecordingEnded)
+        {
+            listener->recordingEnded();
+        }
+    }
 }
 
 void SampleBuffer::releaseResources()
 {
-    fileBuffer.setSize (0, 0);
+    // Clearing drops any pass in progress, so the recording can't carry on into an empty loop
+    loop.clear();
+    isRecording = false;
+    position = 0;
 }
 
 // Play/Record managing ==============================================================================
@@ -126,9 +179,10 @@ void SampleBuffer::stopPlaying()
 
 void SampleBuffer::record(int numChannels, int numSamples)
 {
-    if(!isRecording)
+    // Waits until the previous pass has been kept as a layer
+    if(!isRecording && loop.startLayer (numChannels, numSamples))
     {
-        fileBuffer.setSize(numChannels, numSamples);
+        sample = nullptr;
         isRecording = true;
         stopPlaying();
         position = 0;
@@ -140,8 +194,63 @@ void SampleBuffer::stopRecording()
     if(isRecording) isRecording = false;
 }
 
+void SampleBuffer::armRecording()
+{
+    if (streamToDisk)
+    {
+        const auto& mixdown = loop.getMixdown();
+        fileWriter->startTake (mixdown.getNumSamples() > 0 ? mixdown.getNumChannels() : (int) LoopLayers::maxChannels, sampleRate);
+    }
+}
+
+void SampleBuffer::commitRecording()
+{
+    auto coversLoop = loop.commitLayer (sampleRate);
+
+    if (streamToDisk)
+    {
+        fileWriter->finishTake (coversLoop);
+    }
+}
+
+bool SampleBuffer::undo()
+{
+    if (isRecording || ! loop.undo())
+    {
+        return false;
+    }
+
+    // A streamed take no longer matches the loop
+    if (fileWriter != nullptr)
+    {
+        fileWriter->discardTake();
+    }
+    return true;
+}
+
+bool SampleBuffer::redo()
+{
+    if (isRecording || ! loop.redo())
+    {
+        return false;
+    }
+
+    if (fileWriter != nullptr)
+    {
+        fileWriter->discardTake();
+    }
+    return true;
+}
+
 // File Operations ==============================================================================
 void SampleBuffer::loadAudioFileFromAsset (juce::String fileName)
+{
+    // Only the first buffer asking for an asset decodes it, the rest share it
+    sample = cache->load (fileName, [fileName] { return openAsset (fileName); });
+    position = 0;
+}
+
+std::unique_ptr<juce::InputStream> SampleBuffer::openAsset (const juce::String& fileName)
 {
     std::unique_ptr<juce::InputStream> inputStream;
 #if JUCE_ANDROID
@@ -156,42 +265,35 @@ void SampleBuffer::loadAudioFileFromAsset (juce::String fileName)
     jassert (file.existsAsFile());
     inputStream = file.createInputStream();
 #endif
-    // Once file opening succeeds, create a reader
-    auto* reader = formatManager.createReaderFor (std::move (inputStream));
-    if (reader != nullptr)
-    {
-        // Set the size and channel number for the audio buffer based on the sound file we read
-        fileBuffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+    return inputStream;
+}
 
-        // Read the file content and write it in the audio buffer
-        reader->read (&fileBuffer, 0, (int) reader->lengthInSamples, 0, true, true);
+void SampleBuffer::setStreamToDisk (bool shouldStream)
+{
+    if (shouldStream && fileWriter == nullptr)
+    {
+        fileWriter.reset (new LoopFileWriter());
     }
+    streamToDisk = shouldStream;
 }
 
 void SampleBuffer::write(juce::String fileName) {
     
-    // Get the file stream for saving wave file
-    auto parentDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
-    juce::File file(parentDir.getFullPathName() + "/" + fileName);
-    std::unique_ptr<juce::FileOutputStream> fileStream (file.createOutputStream());
-    
-    if(fileStream != nullptr)
+    // A pass in progress isn't a layer yet
+    if (isRecording)
     {
-        // Tell file stream to start from the beginning of the file and delete existing data
-        fileStream->setPosition (0);
-        fileStream->truncate();
-        
-        // Create a writer
-        juce::WavAudioFormat format;
-        std::unique_ptr<juce::AudioFormatWriter> writer;
-        writer.reset (format.createWriterFor (fileStream.get(), 44100, 1, 24, {}, 0));
-        
-        if (writer != nullptr) // Write the buffer content if the writer exits
-        {
-            fileStream.release(); // passes responsibility for deleting the stream to the writer object
-            writer->writeFromAudioSampleBuffer(fileBuffer, 0, fileBuffer.getNumSamples());
-        }
+        return;
     }
+
+    // Nothing is written here. The writer either renames a streamed take or writes on its own thread.
+    if (fileWriter == nullptr)
+    {
+        fileWriter.reset (new LoopFileWriter());
+    }
+
+    const auto& mixdown = loop.getMixdown();
+    auto file = juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory).getChildFile (fileName);
+    fileWriter->save (file, loop.getLayers(), mixdown.getNumChannels(), mixdown.getNumSamples(), sampleRate);
 }
 
 void SampleBuffer::read(juce::String fileName)
@@ -205,15 +307,23 @@ void SampleBuffer::read(juce::String fileName)
         auto inputStream = file.createInputStream(); // Create an input stream
         
         // Once file opening succeeds, create a reader
-        auto* reader = formatManager.createReaderFor (std::move (inputStream));
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (std::move (inputStream)));
 
         if (reader != nullptr)
         {
+            sample = nullptr;
+
             // Set the size and channel number for the audio buffer based on the sound file we read
-            fileBuffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+            juce::AudioBuffer<float> fileBuffer ((int) reader->numChannels, (int) reader->lengthInSamples);
 
-            // Read the file content and write it in the audio buffer
+            // Read the file content and write it in the audio buffer, then keep it as the loop's first layer
             reader->read (&fileBuffer, 0, (int) reader->lengthInSamples, 0, true, true);
+            loop.load (std::move (fileBuffer), reader->sampleRate);
+
+            if (fileWriter != nullptr)
+            {
+                fileWriter->discardTake();
+            }
         }
     }
 }
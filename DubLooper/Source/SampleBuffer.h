@@ -10,6 +10,9 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "SampleCache.h"
+#include "LoopLayers.h"
+#include "LoopFileWriter.h"
 
 class SampleBuffer
 {
@@ -20,21 +23,53 @@ public:
         formatManager.registerBasicFormats();
     }
 
+    // Reserves the loop's memory for sampleRate, so recording never allocates
+    void prepareToPlay (double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        loop.prepare (sampleRate);
+    }
+
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
     void releaseResources();
     
-    // Play/Record functions
+    // Play/Record functions. Recording over an existing loop adds a layer to it
+    // and plays the loop underneath.
     void play();
     void stopPlaying();
     void record (int numChannels, int numSamples);
     void stopRecording();
     void enableLoop (bool isLooping);
+
+    // Message thread, before a count-in. Opens the take file the pass streams into, if streaming.
+    void armRecording();
+
+    // Message thread. Keeps the last recorded pass as a layer once it has stopped.
+    void commitRecording();
+
+    // Message thread. Removes or restores the newest layer. Not while recording.
+    bool undo();
+    bool redo();
+
+    bool canUndo() const
+    {
+        return loop.canUndo();
+    }
+
+    bool canRedo() const
+    {
+        return loop.canRedo();
+    }
     
-    // File managing
+    // File managing. write returns straight away and saves in the background.
     void loadAudioFileFromAsset (juce::String fileName);
     void write (juce::String fileName);
     void read (juce::String fileName);
 
+    // Message thread, before audio starts. Streams each recorded pass to disk
+    // while it is captured, so a save straight after it is just a rename.
+    void setStreamToDisk (bool shouldStream);
+
     bool getIsPlaying() const
     {
         return isPlaying;
@@ -47,12 +82,19 @@ public:
 
     int getNumSamples() const
     {
-        return fileBuffer.getNumSamples();
+        return sample != nullptr ? sample->getNumSamples() : loop.getNumSamples();
     }
 
-    juce::AudioBuffer<float> getBuffer()
+    // Message thread. The loop, read in place. While recording, only the part
+    // already reported by recordingProgressed is settled.
+    const PagedBuffer& getLoop() const
     {
-        return fileBuffer;
+        return loop.getMixdown();
+    }
+
+    double getSampleRate() const
+    {
+        return sampleRate;
     }
 
     class Listener
@@ -61,6 +103,9 @@ public:
         virtual ~Listener(){}
         virtual void playingEnded() = 0;
         virtual void recordingEnded() = 0;
+
+        // Called after each recorded block with how much of the loop is recorded so far
+        virtual void recordingProgressed (int numSamplesRecorded) = 0;
     };
 
     void setListener(Listener* listener)
@@ -69,11 +114,18 @@ public:
     }
 
 private:
+    static std::unique_ptr<juce::InputStream> openAsset (const juce::String& fileName);
 
     juce::AudioFormatManager formatManager;
-    juce::AudioBuffer<float> fileBuffer;
+    LoopLayers loop;
+    std::unique_ptr<LoopFileWriter> fileWriter;
+    bool streamToDisk = false;
+    juce::SharedResourcePointer<SampleCache> cache;
+    CachedSample::Ptr sample;
 
+    double sampleRate = 44100.0;
     int position = 0;
+    int playbackLength = 0;
     bool isPlaying = false;
     bool isLooping = false;
     bool isRecording = false;
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    AudioThreadGuard.h
+    Created: 17 Oct 2026 4:40:12pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Set by the Android exporter together with the -Wl,--wrap linker flags that
+// route malloc, calloc, realloc and free through AudioThreadGuard.cpp
+#ifndef AUDIOTHREADGUARD_WRAP_MALLOC
+ #define AUDIOTHREADGUARD_WRAP_MALLOC 0
+#endif
+
+// Put one of these at the top of getNextAudioBlock. In debug builds any call to
+// malloc, calloc, realloc or free on that thread while it is alive hits an
+// assertion, so allocations that cause dropouts show up straight away with a
+// call stack. Android wraps those functions at link time and Apple platforms
+// hook the malloc zones. Anywhere else only operator new and delete are caught.
+// In release builds it does nothing.
+class AudioThreadGuard
+{
+public:
+    AudioThreadGuard() noexcept;
+    ~AudioThreadGuard() noexcept;
+
+    // Called by the global allocation functions
+    static void checkAllocation() noexcept;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (AudioThreadGuard)
+};
@@ -10,42 +10,157 @@
 
 #include "Finger.h"
 
-void Finger::pushPoint (juce::Point<float> newPoint, float pressure)
+void Finger::startTrail (juce::Point<float> point)
 {
-    currentPosition = newPoint;
+    clearPath();
+    trail[0] = { point, 0.0f };
+    trailSize = 1;
+}
 
-    if (lastPoint.getDistanceFrom (newPoint) > 5.0f)
+Finger::TrailChange Finger::pushPoint (juce::Point<float> newPoint, float pressure)
+{
+    if (trailSize == 0)
     {
-        if (lastPoint != juce::Point<float>())
-        {
-            juce::Path newSegment;
-            newSegment.startNewSubPath (lastPoint);
-            newSegment.lineTo (newPoint);
+        startTrail (newPoint);
+        return TrailChange::none;
+    }
 
-            auto diameter = 20.0f * (pressure > 0 && pressure < 1.0f ? pressure : 1.0f);
+    if (getTrailPoint (trailSize - 1).position.getDistanceFrom (newPoint) <= 5.0f)
+    {
+        return TrailChange::none;
+    }
 
-            juce::PathStrokeType (diameter, juce::PathStrokeType::curved, juce::PathStrokeType::rounded).createStrokedPath (newSegment, newSegment);
-            path.addPath (newSegment);
-        }
+    auto change = TrailChange::extended;
 
-        lastPoint = newPoint;
+    // Drop a quarter of the trail at a time so the full redraw doesn't happen on every point
+    if (trailSize == maxTrailPoints)
+    {
+        trailStart = (trailStart + maxTrailPoints / 4) % maxTrailPoints;
+        trailSize -= maxTrailPoints / 4;
+        change = TrailChange::trimmed;
     }
+
+    auto diameter = 20.0f * (pressure > 0 && pressure < 1.0f ? pressure : 1.0f);
+    trail[(trailStart + trailSize) % maxTrailPoints] = { newPoint, diameter };
+    ++trailSize;
+
+    return change;
 }
 
-void Finger::draw (juce::Graphics& g)
+void Finger::draw (juce::Graphics& g) const
 {
     g.setColour (color);
-    g.fillPath (path);
+
+    for (int i = 1; i < trailSize; ++i)
+    {
+        drawSegment (g, i);
+    }
+}
+
+void Finger::drawLastSegment (juce::Graphics& g) const
+{
+    if (trailSize > 1)
+    {
+        g.setColour (color);
+        drawSegment (g, trailSize - 1);
+    }
+}
+
+juce::Rectangle<int> Finger::getLastSegmentBounds() const
+{
+    if (trailSize < 2)
+    {
+        return {};
+    }
+
+    return getSegmentBounds (trailSize - 1).getSmallestIntegerContainer();
+}
+
+juce::Rectangle<int> Finger::getTrailBounds() const
+{
+    juce::Rectangle<float> bounds;
+
+    for (int i = 1; i < trailSize; ++i)
+    {
+        bounds = bounds.getUnion (getSegmentBounds (i));
+    }
+
+    return bounds.getSmallestIntegerContainer();
+}
+
+void Finger::drawSegment (juce::Graphics& g, int index) const
+{
+    // Segment i runs from point i - 1 to point i, with the width of point i
+    auto& start = getTrailPoint (index - 1);
+    auto& end = getTrailPoint (index);
+
+    juce::Path segment;
+    segment.startNewSubPath (start.position);
+    segment.lineTo (end.position);
+    g.strokePath (segment, juce::PathStrokeType (end.diameter, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+}
+
+juce::Rectangle<float> Finger::getSegmentBounds (int index) const
+{
+    auto& end = getTrailPoint (index);
+    auto radius = end.diameter * 0.5f + 1.0f;
+
+    return juce::Rectangle<float> (getTrailPoint (index - 1).position, end.position).expanded (radius);
 }
 
 void Finger::prepareToPlay (int samplesPerBlockExpected, double sampleRate, int numChans)
 {
     synth.prepareToPlay (samplesPerBlockExpected, sampleRate, numChans);
+
+    // Room for every event the queue can hold plus one kept aside, so addEvent never allocates
+    events.clearQuick();
+    events.ensureStorageAllocated (TouchEventQueue::capacity + 1);
+}
+
+void Finger::addEvent (const TouchEvent& event, int sampleOffset)
+{
+    events.add (BlockEvent { event.type, event.position, sampleOffset });
 }
 
 void Finger::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    synth.setFrequency (20.0f + (currentPosition.getY() / bound.getHeight()) * 800.0f);
-    synth.setCutoffFrequency (100.0f + (currentPosition.getX() / bound.getWidth()) * 5000.0f);
-    synth.getNextAudioBlock (bufferToFill);
+    // Render up to each touch, apply it, then carry on from there
+    int startSample = 0;
+    for (auto& event : events)
+    {
+        renderSegment (bufferToFill, startSample, event.sampleOffset);
+        startSample = juce::jmax (startSample, event.sampleOffset);
+        applyEvent (event);
+    }
+    renderSegment (bufferToFill, startSample, bufferToFill.numSamples);
+
+    events.clearQuick();
+}
+
+void Finger::renderSegment (const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int endSample)
+{
+    if (endSample > startSample)
+    {
+        synth.getNextAudioBlock (juce::AudioSourceChannelInfo (bufferToFill.buffer, bufferToFill.startSample + startSample, endSample - startSample));
+    }
+}
+
+void Finger::applyEvent (const BlockEvent& event)
+{
+    if (event.type != TouchEvent::Type::up)
+    {
+        // The oscillator and filter smooth these per sample from here on.
+        // A new touch jumps straight to its pitch instead of gliding from the last one.
+        synth.setFrequency (20.0f + (event.position.getY() / bound.getHeight()) * 800.0f, event.type == TouchEvent::Type::down);
+        synth.setCutoffFrequency (100.0f + (event.position.getX() / bound.getWidth()) * 5000.0f);
+    }
+
+    if (event.type == TouchEvent::Type::down)
+    {
+        synth.on();
+    }
+    else if (event.type == TouchEvent::Type::up)
+    {
+        synth.off();
+    }
 }
@@ -11,21 +11,39 @@
 #pragma once
 #include <JuceHeader.h>
 #include "Synth.h"
+#include "TouchEventQueue.h"
 
 class Finger
 {
 public:
     Finger(juce::Rectangle<int> bound) : bound (bound) {}
     
-    void pushPoint (juce::Point<float> newPoint, float pressure);
-    void draw (juce::Graphics& g);
+    enum class TrailChange
+    {
+        none,
+        extended,   // one new segment, see drawLastSegment()
+        trimmed     // old points were dropped, so the whole trail must be redrawn
+    };
+    
+    // The trail keeps at most maxTrailPoints points and drops the oldest ones beyond that
+    void startTrail (juce::Point<float> point);
+    TrailChange pushPoint (juce::Point<float> newPoint, float pressure);
+    
+    void draw (juce::Graphics& g) const;
+    void drawLastSegment (juce::Graphics& g) const;
+    juce::Rectangle<int> getLastSegmentBounds() const;
+    juce::Rectangle<int> getTrailBounds() const;
     
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate, int numChans);
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
     
+    // Audio thread. Schedules a touch at a sample offset in the next block.
+    void addEvent (const TouchEvent& event, int sampleOffset);
+    
     void clearPath()
     {
-        path.clear();
+        trailStart = 0;
+        trailSize = 0;
     }
     
     void setIsTouching(const bool isTouching)
@@ -38,28 +56,47 @@ public:
         return isTouching;
     }
     
-    void setLastPoint (const juce::Point<float> point)
+    // True while the finger is sounding or has a touch waiting for the next block
+    bool isActive() const
     {
-        lastPoint = point;
+        return synth.isActive() || ! events.isEmpty();
     }
     
-    void play()
+private:
+    struct BlockEvent
     {
-        synth.on();
-    }
-    
-    void stop()
+        TouchEvent::Type type;
+        juce::Point<float> position;
+        int sampleOffset;
+    };
+
+    struct TrailPoint
     {
-        synth.off();
+        juce::Point<float> position;
+        float diameter;
+    };
+
+    const TrailPoint& getTrailPoint (int index) const
+    {
+        return trail[(trailStart + index) % maxTrailPoints];
     }
-    
-private:
+
+    void drawSegment (juce::Graphics& g, int index) const;
+    juce::Rectangle<float> getSegmentBounds (int index) const;
+
+    void renderSegment (const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int endSample);
+    void applyEvent (const BlockEvent& event);
+
     juce::Rectangle<int> bound;
-    juce::Path path;
     juce::Colour color  { juce::Colour::fromHSV (juce::Random::getSystemRandom().nextFloat(), 0.5f, 0.8f, 1.0f) };
-    juce::Point<float> lastPoint, currentPosition;
+    
+    static constexpr int maxTrailPoints = 256;
+    TrailPoint trail[maxTrailPoints];
+    int trailStart { 0 };
+    int trailSize { 0 };
     bool isTouching { false };
     Synth synth;
+    juce::Array<BlockEvent> events;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Finger)
 };
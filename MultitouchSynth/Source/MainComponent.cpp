@@ -1,6 +1,7 @@
 #include "MainComponent.h"
 
 int MainComponent::MAX_FINGERS = 10;
+bool MainComponent::USE_RENDER_THREADS = true;
 
 //==============================================================================
 MainComponent::MainComponent()
@@ -21,10 +22,14 @@ MainComponent::MainComponent()
         // Specify the number of input and output channels that we want to open
         setAudioChannels (0, 2);
     }
+    
+    startTimerHz (60);
 }
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+    
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
 }
@@ -32,12 +37,30 @@ MainComponent::~MainComponent()
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    // Create all fingers
-    for (int i = 0; i < MainComponent::MAX_FINGERS; ++i)
+    // Create all fingers once, and only prepare them again when the device restarts
+    jassert (MainComponent::MAX_FINGERS <= TouchEventQueue::maxFingers);
+    for (int i = fingers.size(); i < MainComponent::MAX_FINGERS; ++i)
     {
         fingers.add (new Finger (getBounds()));
-        fingers[i]->prepareToPlay(samplesPerBlockExpected, sampleRate, 2);
     }
+
+    for (auto* finger : fingers)
+    {
+        finger->prepareToPlay (samplesPerBlockExpected, sampleRate, 2);
+    }
+    activeFingers.ensureStorageAllocated (MainComponent::MAX_FINGERS);
+
+   #if MULTITOUCHSYNTH_BENCHMARK
+    juce::Logger::writeToLog (VoiceRenderPool::runBenchmark (sampleRate, samplesPerBlockExpected, MainComponent::MAX_FINGERS, 2000));
+    for (auto blockSize : { 64, 512 })
+    {
+        juce::Logger::writeToLog (Synth::runBenchmark (sampleRate, blockSize, 20000));
+    }
+   #endif
+
+    // Leave one core for the audio thread itself, and don't take over the whole phone
+    auto numWorkers = USE_RENDER_THREADS ? juce::jlimit (0, 3, juce::SystemStats::getNumCpus() - 1) : 0;
+    renderPool.prepare (numWorkers, 2, samplesPerBlockExpected, sampleRate);
     
     // Intialize processor chain
     juce::dsp::ProcessSpec spec;
@@ -45,18 +68,59 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     spec.maximumBlockSize = samplesPerBlockExpected;
     spec.numChannels = 2;
     reverb.prepare (spec);
+    
+    lastBlockTime = juce::Time::getMillisecondCounterHiRes();
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    AudioThreadGuard guard;
+
+    // Fingers add themselves to the output, so start from silence
+    bufferToFill.clearActiveBufferRegion();
+
+    // Touches that arrived during the last block are placed at the same relative
+    // position in this one. That costs one block of latency but keeps the timing.
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    auto blockLength = now - lastBlockTime;
+    auto numEvents = touchEvents.getNumReady();
+    TouchEvent event;
+
+    for (int i = 0; i < numEvents && touchEvents.pop (event); ++i)
+    {
+        if (juce::isPositiveAndBelow (event.finger, fingers.size()))
+        {
+            auto offset = blockLength > 0.0 ? juce::roundToInt ((event.time - lastBlockTime) / blockLength * bufferToFill.numSamples) : 0;
+            fingers[event.finger]->addEvent (event, juce::jlimit (0, bufferToFill.numSamples - 1, offset));
+        }
+    }
+
+    // A press that didn't fit in the queue is newer than anything above, so it goes last
+    for (int i = 0; i < fingers.size(); ++i)
+    {
+        if (touchEvents.popOverflow (i, event))
+        {
+            fingers[i]->addEvent (event, bufferToFill.numSamples - 1);
+        }
+    }
+    lastBlockTime = now;
+
+    // Fingers whose envelope has finished are skipped entirely
+    activeFingers.clearQuick();
     for (auto* finger : fingers)
     {
-        finger->getNextAudioBlock (bufferToFill);
+        if (finger->isActive())
+        {
+            activeFingers.add (finger);
+        }
     }
+    numActiveVoices = activeFingers.size();
+
+    renderPool.render (activeFingers.getRawDataPointer(), activeFingers.size(), bufferToFill);
 
-    juce::AudioBuffer<float> buffer = *bufferToFill.buffer;
-    juce::dsp::AudioBlock<float> block (buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
+    juce::dsp::AudioBlock<float> block (*bufferToFill.buffer);
+    auto subBlock = block.getSubBlock ((size_t) bufferToFill.startSample, (size_t) bufferToFill.numSamples);
+    juce::dsp::ProcessContextReplacing<float> context (subBlock);
     reverb.process (context);
 }
 
@@ -66,6 +130,7 @@ void MainComponent::releaseResources()
     // restarted due to a setting change.
 
     // For more details, see the help for AudioProcessor::releaseResources()
+    renderPool.release();
 }
 
 //==============================================================================
@@ -73,14 +138,7 @@ void MainComponent::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    for(auto* finger : fingers)
-    {
-        if(finger->getIsTouching())
-        {
-            finger->draw (g);
-        }
-    }
+    g.drawImageAt (trailLayer, 0, 0);
 }
 
 void MainComponent::resized()
@@ -88,6 +146,8 @@ void MainComponent::resized()
     // This is called when the MainContentComponent is resized.
     // If you add any child components, this is where you should
     // update their positions.
+    trailLayer = juce::Image (juce::Image::ARGB, juce::jmax (1, getWidth()), juce::jmax (1, getHeight()), true);
+    redrawTrails (getLocalBounds());
 }
 
 void MainComponent::mouseDown (const juce::MouseEvent &event)
@@ -95,19 +155,32 @@ void MainComponent::mouseDown (const juce::MouseEvent &event)
     if (!fingers[event.source.getIndex()]->getIsTouching())
     {
         fingers[event.source.getIndex()]->setIsTouching (true);
-        fingers[event.source.getIndex()]->setLastPoint (event.position);
-        fingers[event.source.getIndex()]->pushPoint (event.position, event.pressure);
-        repaint();
-        fingers[event.source.getIndex()]->play();
+        fingers[event.source.getIndex()]->startTrail (event.position);
+        pushTouch (event, TouchEvent::Type::down);
     }
 }
 
 void MainComponent::mouseDrag (const juce::MouseEvent& event)
 {
-    if (fingers[event.source.getIndex()]->getIsTouching())
+    auto* finger = fingers[event.source.getIndex()];
+    if (finger->getIsTouching())
     {
-        fingers[event.source.getIndex()]->pushPoint (event.position, event.pressure);
-        repaint();
+        auto oldBounds = finger->getTrailBounds();
+        auto change = finger->pushPoint (event.position, event.pressure);
+
+        if (change == Finger::TrailChange::extended)
+        {
+            // Only the new segment needs drawing
+            juce::Graphics g (trailLayer);
+            finger->drawLastSegment (g);
+            dirtyRegion.add (finger->getLastSegmentBounds());
+        }
+        else if (change == Finger::TrailChange::trimmed)
+        {
+            redrawTrails (oldBounds.getUnion (finger->getLastSegmentBounds()));
+        }
+
+        pushTouch (event, TouchEvent::Type::move);
     }
 }
 
@@ -115,9 +188,45 @@ void MainComponent::mouseUp (const juce::MouseEvent &event)
 {
     if (fingers[event.source.getIndex()]->getIsTouching())
     {
+        auto trailBounds = fingers[event.source.getIndex()]->getTrailBounds();
         fingers[event.source.getIndex()]->setIsTouching (false);
         fingers[event.source.getIndex()]->clearPath();
-        repaint();
-        fingers[event.source.getIndex()]->stop();
+        redrawTrails (trailBounds);
+        pushTouch (event, TouchEvent::Type::up);
+    }
+}
+
+void MainComponent::pushTouch (const juce::MouseEvent& event, TouchEvent::Type type)
+{
+    // The audio thread picks this up at the start of the next block. Only moves are
+    // ever dropped, and only when the queue is nearly full.
+    touchEvents.push ({ type, event.source.getIndex(), event.position, juce::Time::getMillisecondCounterHiRes() });
+}
+
+void MainComponent::redrawTrails (juce::Rectangle<int> area)
+{
+    // Clear the area and draw back whatever the other fingers have there
+    trailLayer.clear (area);
+    juce::Graphics g (trailLayer);
+    g.reduceClipRegion (area);
+
+    for (auto* finger : fingers)
+    {
+        if (finger->getIsTouching())
+        {
+            finger->draw (g);
+        }
+    }
+
+    dirtyRegion.add (area);
+}
+
+void MainComponent::timerCallback()
+{
+    // All the changes since the last frame go out as one repaint per rectangle
+    for (auto& area : dirtyRegion)
+    {
+        repaint (area);
     }
+    dirtyRegion.clear();
 }
@@ -2,13 +2,15 @@
 
 #include <JuceHeader.h>
 #include "Finger.h"
+#include "VoiceRenderPool.h"
+#include "AudioThreadGuard.h"
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::AudioAppComponent
+class MainComponent  : public juce::AudioAppComponent, private juce::Timer
 {
 public:
     //==============================================================================
@@ -28,11 +30,32 @@ public:
     void mouseDrag (const juce::MouseEvent& event) override;
     void mouseUp (const juce::MouseEvent &event) override;
     
+    // Number of fingers that were sounding in the last audio block
+    int getNumActiveVoices() const
+    {
+        return numActiveVoices.get();
+    }
+    
 private:
     //==============================================================================
+    void pushTouch (const juce::MouseEvent& event, TouchEvent::Type type);
+    void redrawTrails (juce::Rectangle<int> area);
+    void timerCallback() override;
+    
     juce::OwnedArray<Finger> fingers;
     int fingerCount { 0 };
     static int MAX_FINGERS;
+    static bool USE_RENDER_THREADS;
+    juce::Atomic<int> numActiveVoices { 0 };
+    juce::Array<Finger*> activeFingers;
+    TouchEventQueue touchEvents;
+    double lastBlockTime { 0.0 };
+    
+    // Finger trails are drawn once into this layer and only the changed parts
+    // are repainted, at most once per display frame
+    juce::Image trailLayer;
+    juce::RectangleList<int> dirtyRegion;
+    VoiceRenderPool renderPool;
     juce::dsp::Reverb reverb;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
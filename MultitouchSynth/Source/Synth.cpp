@@ -10,61 +10,112 @@
 
 #include "Synth.h"
 
+namespace
+{
+    // Shared by the synth and the benchmark so both chains sound the same
+    template <typename Chain>
+    void setUpChain (Chain& chain)
+    {
+        // Oscillator setup
+        auto& osc = chain.template get<0>();
+        osc.initialise ([] (float x)
+            {
+                return juce::jmap (x,
+                                   float (-juce::MathConstants<float>::pi),
+                                   float (juce::MathConstants<float>::pi),
+                                   float (-1),
+                                   float (1));
+            }, 2);
+        osc.setFrequency (440, true);
+        
+        // Filter setup
+        chain.template get<1>().setMode (juce::dsp::LadderFilterMode::LPF24);
+        chain.template get<1>().setCutoffFrequencyHz (5000.0f);
+        chain.template get<1>().setResonance (0.7f);
+        
+        // Gain setup
+        chain.template get<2>().setGainLinear (0.05f);
+    }
+}
+
 void Synth::prepareToPlay (int samplesPerBlockExpected, double sampleRate, int numChans)
 {
-    // Intialize processor chain
+    // Intialize processor chain. This also sets the ADSR's sample rate.
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlockExpected;
     spec.numChannels = numChans;
     processorChain.prepare (spec);
-    
-    // Oscillator setup
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-        {
-            return juce::jmap (x,
-                               float (-juce::MathConstants<float>::pi),
-                               float (juce::MathConstants<float>::pi),
-                               float (-1),
-                               float (1));
-        }, 2);
-    processorChain.get<oscIndex>().setFrequency (440, true);
-    
-    // Filter setup
-    processorChain.get<filterIndex>().setMode (juce::dsp::LadderFilterMode::LPF24);
-    processorChain.get<filterIndex>().setCutoffFrequencyHz (5000.0f);
-    processorChain.get<filterIndex>().setResonance (0.7f);
-    
-    // Gain setup
-    processorChain.get<gainIndex>().setGainLinear (0.05f);
-    
-    // ADSR setup
-    adsr.setSampleRate (sampleRate);
-    adsr.reset();
+    processorChain.reset();
+    setUpChain (processorChain);
     
     this->numChans = numChans;
 }
 
 void Synth::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    juce::AudioBuffer<float> audioBuffer = *bufferToFill.buffer;
-    auto numSamples = audioBuffer.getNumSamples();
+    // Silent voices cost nothing
+    if (! isActive())
+    {
+        return;
+    }
 
-    buffer.makeCopyOf (audioBuffer);
-    juce::dsp::AudioBlock<float> block (buffer);
-    juce::dsp::ProcessContextReplacing<float> context (block);
-    processorChain.process (context);
-    adsr.applyEnvelopeToBuffer (buffer, 0, buffer.getNumSamples());
-    
-    // Copy audio data to the main audio buffer
-    for (int channel = 0; channel < numChans; ++channel)
+    // Oscillator, filter, gain and envelope run sample by sample and mix straight into the output
+    juce::dsp::AudioBlock<float> block (*bufferToFill.buffer);
+    auto numChannels = juce::jmin ((size_t) numChans, block.getNumChannels());
+    processorChain.processAdding (block.getSubsetChannelBlock (0, numChannels)
+                                       .getSubBlock ((size_t) bufferToFill.startSample, (size_t) bufferToFill.numSamples));
+
+    // Clear the filter state once the note has died away so the next one starts clean
+    if (! isActive())
     {
-        auto* channelDataIn = buffer.getReadPointer (channel);
-        auto* channelDataOut = audioBuffer.getWritePointer (channel);
-        for (int sample = 0; sample < numSamples; ++sample)
+        processorChain.reset();
+    }
+}
+
+juce::String Synth::runBenchmark (double sampleRate, int blockSize, int numBlocks)
+{
+    juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, 2 };
+    juce::AudioBuffer<float> output (2, blockSize);
+    juce::AudioBuffer<float> scratch (2, blockSize);
+
+    // The way a voice used to render: four passes over a scratch buffer, then a fifth to mix it in
+    juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>> chained;
+    juce::ADSR adsr;
+    chained.prepare (spec);
+    setUpChain (chained);
+    adsr.setSampleRate (sampleRate);
+    adsr.noteOn();
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        scratch.clear();
+        juce::dsp::AudioBlock<float> audioBlock (scratch);
+        juce::dsp::ProcessContextReplacing<float> context (audioBlock);
+        chained.process (context);
+        adsr.applyEnvelopeToBuffer (scratch, 0, blockSize);
+
+        for (int channel = 0; channel < 2; ++channel)
         {
-            channelDataOut[sample] += channelDataIn[sample];
+            output.addFrom (channel, 0, scratch, channel, 0, blockSize);
         }
     }
+    auto chainedTime = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    FusedChain<juce::dsp::Oscillator<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>, juce::ADSR> fused;
+    fused.prepare (spec);
+    setUpChain (fused);
+    fused.get<3>().noteOn();
+
+    startTime = juce::Time::getMillisecondCounterHiRes();
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        fused.processAdding (juce::dsp::AudioBlock<float> (output));
+    }
+    auto fusedTime = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    return "Synth: " + juce::String (numBlocks) + " blocks of " + juce::String (blockSize) + " samples, "
+           + "chained " + juce::String (chainedTime, 2) + " ms, fused " + juce::String (fusedTime, 2) + " ms ("
+           + juce::String (chainedTime / juce::jmax (fusedTime, 0.001), 2) + "x)";
 }
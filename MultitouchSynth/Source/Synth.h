@@ -10,6 +10,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "FusedChain.h"
 
 class Synth
 {
@@ -19,17 +20,23 @@ public:
 
     void on()
     {
-        adsr.noteOn();
+        processorChain.get<envelopeIndex>().noteOn();
     }
 
     void off()
     {
-        adsr.noteOff();
+        processorChain.get<envelopeIndex>().noteOff();
     }
     
-    void setFrequency (const float frequency)
+    // False once the envelope has finished releasing
+    bool isActive() const
     {
-        processorChain.get<oscIndex>().setFrequency (frequency);
+        return processorChain.get<envelopeIndex>().isActive();
+    }
+    
+    void setFrequency (const float frequency, const bool force = false)
+    {
+        processorChain.get<oscIndex>().setFrequency (frequency, force);
     }
     
     void setCutoffFrequency (const float cutoff)
@@ -37,16 +44,25 @@ public:
         processorChain.get<filterIndex>().setCutoffFrequencyHz (cutoff);
     }
     
+    // Times the fused chain against the separate ProcessorChain and ADSR passes
+    // it replaced. This allocates, so never call it while playing.
+    static juce::String runBenchmark (double sampleRate, int blockSize, int numBlocks);
+    
 private:
     enum
     {
         oscIndex,
         filterIndex,
-        gainIndex
+        gainIndex,
+        envelopeIndex
     };
     
-    juce::AudioBuffer<float> buffer;
     int numChans { 2 };
-    juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>> processorChain;
-    juce::ADSR adsr;
+
+    // Every finger keeps its own oscillator rather than sharing a SIMD bank like
+    // ClassroomSynthesizer's OscillatorBank. The oscillator is a two-point lookup
+    // that costs little next to the ladder filter after it, and both the fused
+    // per-sample loop and VoiceRenderPool's split of fingers across threads need
+    // each voice to render on its own.
+    FusedChain<juce::dsp::Oscillator<float>, juce::dsp::LadderFilter<float>, juce::dsp::Gain<float>, juce::ADSR> processorChain;
 };
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    TouchEventQueue.cpp
+    Created: 17 Oct 2026 6:12:03pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "TouchEventQueue.h"
+
+bool TouchEventQueue::push (const TouchEvent& event)
+{
+    if (! juce::isPositiveAndBelow (event.finger, (int) maxFingers))
+    {
+        jassertfalse;
+        return false;
+    }
+
+    auto& kept = overflow[event.finger];
+    auto isKeptAside = kept.type.get() != noEvent;
+
+    if (event.type == TouchEvent::Type::move)
+    {
+        // A finger with a press kept aside takes no moves until that press is read,
+        // or they would reach the audio thread before it
+        return ! isKeptAside && fifo.getFreeSpace() > (int) reservedForPresses && write (event);
+    }
+
+    if (isKeptAside || ! write (event))
+    {
+        // Only the latest press matters here, so it replaces any earlier one
+        kept.x = event.position.getX();
+        kept.y = event.position.getY();
+        kept.time = event.time;
+        kept.type = (int) event.type;
+    }
+
+    return true;
+}
+
+bool TouchEventQueue::popOverflow (int finger, TouchEvent& event)
+{
+    if (! juce::isPositiveAndBelow (finger, (int) maxFingers))
+    {
+        return false;
+    }
+
+    auto& kept = overflow[finger];
+    auto type = kept.type.exchange (noEvent);
+
+    if (type == noEvent)
+    {
+        return false;
+    }
+
+    event = { (TouchEvent::Type) type, finger, { kept.x.get(), kept.y.get() }, kept.time.get() };
+    return true;
+}
+
+bool TouchEventQueue::write (const TouchEvent& event)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        events[start1] = event;
+    }
+    fifo.finishedWrite (size1);
+
+    return size1 > 0;
+}
+
+bool TouchEventQueue::pop (TouchEvent& event)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        event = events[start1];
+    }
+    fifo.finishedRead (size1);
+
+    return size1 > 0;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    TouchEventQueue.h
+    Created: 17 Oct 2026 6:12:03pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// A touch as it happened on the message thread
+struct TouchEvent
+{
+    enum class Type
+    {
+        down,
+        move,
+        up
+    };
+
+    Type type;
+    int finger;
+    juce::Point<float> position;
+
+    // Time::getMillisecondCounterHiRes() when the touch was handled
+    double time;
+};
+
+// Carries touches from the message thread to the audio thread. There is one
+// writer and one reader, so a juce::AbstractFifo is enough and neither side
+// ever waits for the other.
+//
+// Down and up are never lost, or a note could be left sounding. Moves stop being
+// queued once the queue is nearly full, since the next one carries a newer position
+// anyway. If even the reserved space runs out, each finger keeps its latest down or
+// up aside until the audio thread takes it with popOverflow().
+class TouchEventQueue
+{
+public:
+    // Message thread. Returns false if the event was a move and was dropped.
+    bool push (const TouchEvent& event);
+
+    // Audio thread. Returns false if there was nothing to read.
+    bool pop (TouchEvent& event);
+
+    // Audio thread. Call after the queued events have been read, since a kept
+    // aside event is always newer than those. Returns false if there was none.
+    bool popOverflow (int finger, TouchEvent& event);
+
+    int getNumReady() const
+    {
+        return fifo.getNumReady();
+    }
+
+    static constexpr int capacity = 512;
+    static constexpr int maxFingers = 16;
+
+private:
+    bool write (const TouchEvent& event);
+
+    // Room left for downs and ups only
+    static constexpr int reservedForPresses = 64;
+
+    // The latest down or up of a finger that didn't fit in the queue
+    struct Overflow
+    {
+        juce::Atomic<int> type { noEvent };
+        juce::Atomic<float> x, y;
+        juce::Atomic<double> time;
+    };
+
+    static constexpr int noEvent = -1;
+
+    juce::AbstractFifo fifo { capacity };
+    TouchEvent events[capacity];
+    Overflow overflow[maxFingers];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TouchEventQueue)
+};
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.cpp
+    Created: 17 Oct 2026 5:26:41pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "VoiceRenderPool.h"
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    release();
+}
+
+void VoiceRenderPool::prepare (int numWorkers, int numChannels, int maximumBlockSize, double sampleRate)
+{
+    release();
+    blockPeriodMs = 1000.0 * maximumBlockSize / sampleRate;
+
+    // One bus for the audio thread's own share plus one per worker
+    buses.clear();
+    for (int i = 0; i <= numWorkers; ++i)
+    {
+        buses.add (new juce::AudioBuffer<float> (numChannels, maximumBlockSize));
+    }
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.add (new Worker (*this, i + 1));
+        workers.getLast()->startThread (juce::Thread::realtimeAudioPriority);
+    }
+}
+
+void VoiceRenderPool::release()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+    }
+
+    for (auto* worker : workers)
+    {
+        worker->stopThread (1000);
+    }
+
+    workers.clear();
+}
+
+void VoiceRenderPool::render (Finger* const* voices, int numVoices, const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto numShares = juce::jmin (workers.size() + 1, numVoices);
+
+    // A single voice, or a block bigger than the buses, isn't worth handing out
+    if (numShares <= 1 || bufferToFill.numSamples > buses[0]->getNumSamples())
+    {
+        for (int i = 0; i < numVoices; ++i)
+        {
+            voices[i]->getNextAudioBlock (bufferToFill);
+        }
+        return;
+    }
+
+    jassert (numShares <= 0xff);
+
+    // Publish the job before opening its shares, then let the workers see it
+    jobVoices = voices;
+    jobNumVoices = numVoices;
+    jobNumShares = numShares;
+    jobNumSamples = bufferToFill.numSamples;
+    numSharesFinished = 0;
+    openShares = (((openShares.get() >> 8) + 1) << 8) | (juce::uint32) (numShares - 1);
+
+    renderShare (0);
+    renderClaimedShares();
+
+    // Only shares a worker is in the middle of are left, so spin rather than sleep
+    while (numSharesFinished.get() < numShares - 1)
+    {
+        juce::Thread::yield();
+    }
+
+    // Always mix the buses in the same order
+    auto& output = *bufferToFill.buffer;
+    auto numChannels = juce::jmin (output.getNumChannels(), buses[0]->getNumChannels());
+    for (int share = 0; share < numShares; ++share)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            output.addFrom (channel, bufferToFill.startSample, *buses[share], channel, 0, jobNumSamples);
+        }
+    }
+}
+
+void VoiceRenderPool::renderShare (int share)
+{
+    auto& bus = *buses[share];
+    bus.clear (0, jobNumSamples);
+
+    // Voices are dealt out round robin, so each share always gets the same ones in the same order
+    juce::AudioSourceChannelInfo info (&bus, 0, jobNumSamples);
+    for (int i = share; i < jobNumVoices; i += jobNumShares)
+    {
+        jobVoices[i]->getNextAudioBlock (info);
+    }
+}
+
+void VoiceRenderPool::renderClaimedShares()
+{
+    // Shares are handed out from the top down. Share 0 always belongs to the audio thread.
+    for (;;)
+    {
+        auto state = openShares.get();
+        auto share = (int) (state & 0xff);
+
+        if (share == 0)
+        {
+            return;
+        }
+
+        if (openShares.compareAndSetBool (state - 1, state))
+        {
+            renderShare (share);
+            ++numSharesFinished;
+        }
+    }
+}
+
+void VoiceRenderPool::Worker::run()
+{
+    auto lastJob = pool.openShares.get() >> 8;
+    auto lastJobTime = juce::Time::getMillisecondCounterHiRes();
+    auto jobInterval = pool.blockPeriodMs;
+
+    while (! threadShouldExit())
+    {
+        auto job = pool.openShares.get() >> 8;
+        auto now = juce::Time::getMillisecondCounterHiRes();
+        auto sinceLastJob = now - lastJobTime;
+
+        if (job != lastJob)
+        {
+            // Jobs come a block period apart in real time, and back to back in the benchmark
+            jobInterval = juce::jmin (sinceLastJob, pool.blockPeriodMs);
+            lastJob = job;
+            lastJobTime = now;
+            pool.renderClaimedShares();
+        }
+        else if (sinceLastJob > jobInterval - spinLeadMs && sinceLastJob < jobInterval + pool.blockPeriodMs)
+        {
+            // The next job is about due, so stay close by for up to a block period
+            juce::Thread::yield();
+        }
+        else
+        {
+            // Between blocks, or with nothing playing. The audio thread picks up any share we are late for.
+            juce::Thread::sleep (1);
+        }
+    }
+}
+
+juce::String VoiceRenderPool::runBenchmark (double sampleRate, int blockSize, int numVoices, int numBlocks)
+{
+    juce::Rectangle<int> bounds (0, 0, 800, 600);
+    juce::OwnedArray<Finger> fingers;
+    juce::Array<Finger*> voices;
+
+    // Spread the fingers over the screen so each voice has its own pitch and cutoff
+    for (int i = 0; i < numVoices; ++i)
+    {
+        auto* finger = fingers.add (new Finger (bounds));
+        finger->prepareToPlay (blockSize, sampleRate, 2);
+        juce::Point<float> position ((float) (i + 1) * 70.0f, (float) (i + 1) * 50.0f);
+        finger->addEvent ({ TouchEvent::Type::down, i, position, 0.0 }, 0);
+        voices.add (finger);
+    }
+
+    juce::AudioBuffer<float> output (2, blockSize);
+    juce::AudioSourceChannelInfo bufferToFill (output);
+    VoiceRenderPool pool;
+
+    juce::String report ("VoiceRenderPool: " + juce::String (numVoices) + " voices, "
+                         + juce::String (numBlocks) + " blocks of " + juce::String (blockSize) + " samples");
+    double singleThreadTime = 0.0;
+
+    for (int numThreads = 1; numThreads <= juce::SystemStats::getNumCpus(); ++numThreads)
+    {
+        pool.prepare (numThreads - 1, 2, blockSize, sampleRate);
+
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            output.clear();
+            pool.render (voices.getRawDataPointer(), voices.size(), bufferToFill);
+        }
+        auto time = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+        if (numThreads == 1)
+        {
+            singleThreadTime = time;
+        }
+
+        report << "\n  " << numThreads << (numThreads == 1 ? " thread: " : " threads: ")
+               << juce::String (time, 2) << " ms (" << juce::String (singleThreadTime / juce::jmax (time, 0.001), 2) << "x)";
+    }
+
+    pool.release();
+    return report;
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.h
+    Created: 17 Oct 2026 5:26:41pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Finger.h"
+
+// Set this to 1 in the Projucer preprocessor definitions to log how rendering
+// scales from one thread to all the cores in prepareToPlay
+#ifndef MULTITOUCHSYNTH_BENCHMARK
+ #define MULTITOUCHSYNTH_BENCHMARK 0
+#endif
+
+// Splits the sounding fingers across worker threads. The audio thread renders
+// one share itself, the workers render the others, each share goes into its own
+// bus, and the buses are then added to the output in a fixed order, so the result doesn't
+// depend on which thread finished first.
+//
+// Nothing here takes a lock. Workers poll one atomic that holds the job number
+// and the count of shares still open, and claim a share by counting it down. Any share no worker has claimed by the time
+// the audio thread is done with its own, it renders itself. A sleeping or
+// descheduled worker therefore costs at most the time to render its share on
+// the audio thread, which is the same as having no workers at all.
+//
+// That also lets the workers sleep between blocks. They only spin from just
+// before the next block is due until a block period after that, so while
+// fingers are down they stay busy for a fraction of each block rather than
+// holding whole cores.
+class VoiceRenderPool
+{
+public:
+    ~VoiceRenderPool();
+
+    // Starts the workers and allocates their buses. Call it from prepareToPlay.
+    void prepare (int numWorkers, int numChannels, int maximumBlockSize, double sampleRate);
+
+    // Stops the workers. Call it from releaseResources.
+    void release();
+
+    // Audio thread. Adds every voice to the output region of bufferToFill.
+    void render (Finger* const* voices, int numVoices, const juce::AudioSourceChannelInfo& bufferToFill);
+
+    int getNumWorkers() const
+    {
+        return workers.size();
+    }
+
+    // Renders the same voices with one thread up to one per core and returns
+    // the timings. This allocates, so never call it while playing.
+    static juce::String runBenchmark (double sampleRate, int blockSize, int numVoices, int numBlocks);
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (VoiceRenderPool& pool, int index)
+            : juce::Thread ("Voice Render " + juce::String (index)), pool (pool) {}
+
+        void run() override;
+
+    private:
+        // How long before the next block is due a worker stops sleeping. Covers
+        // Thread::sleep (1) oversleeping on phones.
+        static constexpr double spinLeadMs = 2.0;
+
+        VoiceRenderPool& pool;
+    };
+
+    void renderShare (int share);
+
+    juce::OwnedArray<Worker> workers;
+    juce::OwnedArray<juce::AudioBuffer<float>> buses;
+    double blockPeriodMs = 0.0;
+
+    void renderClaimedShares();
+
+    // The current job. Written by the audio thread before it opens the shares,
+    // and only read by a thread that has claimed one of them.
+    Finger* const* jobVoices = nullptr;
+    int jobNumVoices = 0;
+    int jobNumShares = 0;
+    int jobNumSamples = 0;
+
+    // Job number in the upper bits and shares left to claim in the low byte. A
+    // claim that raced with the next job fails because the job number changed.
+    juce::Atomic<juce::uint32> openShares { 0 };
+    juce::Atomic<int> numSharesFinished { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceRenderPool)
+};
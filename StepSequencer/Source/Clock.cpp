@@ -10,44 +10,58 @@
 
 #include "Clock.h"
 
-void Clock::run(){
-    while (!threadShouldExit()) {
-        elapsedTime = juce::Time::getMillisecondCounter();
-        
-        if(elapsedTime - time >= interval.get()) {
-            count.set ((count.get() + 1) % step.get());
-            
-            if (listener != nullptr)
-            {
-                listener->tick (count.get());
-            }
-
-            time = elapsedTime;
-        }
-        
-        wait(1);
-    }
+void Clock::prepare (double sampleRate)
+{
+    this->sampleRate = sampleRate;
 }
 
-void Clock::start()
+void Clock::advance (int numSamples)
 {
+    auto running = shouldRun.get();
+
+    if (running != isRunning)
+    {
+        isRunning = running;
+        count = -1;
+
+        // The first step falls on the first sample after starting
+        samplesUntilNextStep = 0.0;
+
+        if (!isRunning && listener != nullptr)
+        {
+            listener->reset();
+        }
+    }
+
     if (!isRunning)
     {
-        startThread (8);
-        isRunning = true;
+        return;
     }
-}
 
-void Clock::stop()
-{
-    if(isRunning)
+    auto samplesPerStep = sampleRate * 24.0 / bpm.get();
+
+    // Fire every step that falls inside this block at its own sample
+    while (samplesUntilNextStep < numSamples)
     {
-        stopThread (500);
-        isRunning = false;
-        count.set (-1);
+        count = (count + 1) % step.get();
+
         if (listener != nullptr)
         {
-            listener->reset();
+            listener->tick (count, (int) samplesUntilNextStep);
         }
+
+        samplesUntilNextStep += samplesPerStep;
     }
+
+    samplesUntilNextStep -= numSamples;
+}
+
+void Clock::start()
+{
+    shouldRun.set (true);
+}
+
+void Clock::stop()
+{
+    shouldRun.set (false);
 }
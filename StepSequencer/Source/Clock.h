@@ -11,20 +11,30 @@
 #pragma once
 #include <JuceHeader.h>
 
-class Clock : private juce::Thread {
+// Counts steps in samples on the audio thread. Every step lands on an exact
+// sample offset inside the block, and the fractional part of the step length
+// carries over from one step to the next so the tempo never drifts.
+class Clock {
 public:
     
-    Clock():Thread ("ClockThread"), time (-1), elapsedTime (0) {}
-    ~Clock(){
-        stopThread (500);
-    }
+    Clock() {}
     
-    void run() override;
+    // Message thread. Takes effect at the start of the next audio block.
     void start();
     void stop();
     
+    // Audio thread
+    void prepare (double sampleRate);
+    void advance (int numSamples);
+    
+    // A step lasts 24 / bpm seconds
     void setBPM (const float bpm){
-        this->interval = 6000.0f / bpm * 4;
+        this->bpm.set (bpm);
+    }
+
+    float getBPM() const
+    {
+        return bpm.get();
     }
         
     class Listener
@@ -32,8 +42,9 @@ public:
     public:
         virtual ~Listener() {}
         
-        // Called when the counter value changes.
-        virtual void tick (int count) = 0;
+        // Called on the audio thread when the counter value changes. sampleOffset
+        // is where the step falls within the block being rendered.
+        virtual void tick (int count, int sampleOffset) = 0;
         
         // Resets the clock
         virtual void reset () = 0;
@@ -55,14 +66,17 @@ public:
     }
     
 private:
-    juce::Atomic<int> interval = 6000.0f / 120 * 4;
-    juce::Atomic<int> count;
+    juce::Atomic<float> bpm = 120.0f;
     juce::Atomic<int> step = 16;
-    juce::uint32 time;
-    juce::uint32 elapsedTime;
+    juce::Atomic<bool> shouldRun = false;
+
+    // Only touched on the audio thread
+    double sampleRate = 44100.0;
+    double samplesUntilNextStep = 0.0;
+    int count = -1;
     bool isRunning = false;
     
-    Listener* listener;
+    Listener* listener = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Clock)
 };
@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    KitLoader.cpp
+    Created: 18 Oct 2026 1:05:12pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "KitLoader.h"
+
+KitLoader::KitLoader()
+    : pool (juce::jmax (1, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+KitLoader::~KitLoader()
+{
+    // Jobs write into pads and tracks, so they must finish before those go away
+    pool.removeAllJobs (true, 5000);
+}
+
+void KitLoader::add (std::function<void()> load, std::function<void()> onLoaded)
+{
+    pool.addJob ([load, onLoaded]
+    {
+        load();
+        juce::MessageManager::callAsync (onLoaded);
+    });
+}
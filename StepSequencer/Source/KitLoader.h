@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    KitLoader.h
+    Created: 18 Oct 2026 1:05:12pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Decodes a kit's samples in parallel on background threads so neither the
+// UI nor the audio device ever waits on file I/O.
+class KitLoader
+{
+public:
+    KitLoader();
+    ~KitLoader();
+
+    // Runs load on a worker thread, then onLoaded on the message thread
+    void add (std::function<void()> load, std::function<void()> onLoaded);
+
+    bool isLoading() const
+    {
+        return pool.getNumJobs() > 0;
+    }
+
+private:
+    juce::ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KitLoader)
+};
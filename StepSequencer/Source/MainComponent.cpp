@@ -7,6 +7,9 @@ MainComponent::MainComponent()
     // you add any child components.
     setSize (800, 600);
 
+    // Create the tracks once, before audio starts. Their samples load once the device rate is known.
+    sequencer.createTracks();
+
     // Some platforms require permissions to open input channels so request that here
     if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
         && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
@@ -26,6 +29,33 @@ MainComponent::MainComponent()
     bpmSlider.setRange (60.0f, 360.0f, 1.0f);
     bpmSlider.setValue (120);
     bpmSlider.setTextBoxStyle (juce::Slider::TextBoxRight, true, 80, 20);
+
+    // Choosing a pattern edits it straight away and plays it from the next bar
+    for (int i = 0; i < PatternBank::numPatterns; ++i)
+    {
+        patternBox.addItem ("Pattern " + juce::String (i + 1), i + 1);
+    }
+    patternBox.setSelectedId (1, juce::dontSendNotification);
+    patternBox.onChange = [this] { sequencer.selectPattern (patternBox.getSelectedId() - 1); };
+
+    // Renders four bars of the selected pattern to a WAV file in the background
+    bounceButton.setButtonText ("Bounce");
+    bounceButton.onClick = [this]
+    {
+        bounceButton.setEnabled (false);
+
+        // The bounce finishes later on the message thread, by which time the window may have closed
+        juce::Component::SafePointer<MainComponent> safeThis (this);
+        sequencer.bounce ({ patternBox.getSelectedId() - 1 }, 4, false, [safeThis] (int numWritten)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->bounceButton.setEnabled (true);
+            }
+
+            juce::Logger::writeToLog ("Bounced " + juce::String (numWritten) + " pattern(s)");
+        });
+    };
 }
 
 MainComponent::~MainComponent()
@@ -37,7 +67,7 @@ MainComponent::~MainComponent()
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    sequencer.createTracks();
+    sequencer.prepareToPlay (sampleRate);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -63,7 +93,13 @@ void MainComponent::paint (juce::Graphics& g)
     playButton.setBounds (60, getHeight() - 50, 100, 30);
     
     addAndMakeVisible (bpmSlider);
-    bpmSlider.setBounds (160, getHeight() - 50, getWidth() - 235, 30);
+    bpmSlider.setBounds (160, getHeight() - 50, getWidth() - 465, 30);
+
+    addAndMakeVisible (bounceButton);
+    bounceButton.setBounds (getWidth() - 290, getHeight() - 50, 100, 30);
+
+    addAndMakeVisible (patternBox);
+    patternBox.setBounds (getWidth() - 180, getHeight() - 50, 120, 30);
 }
 
 void MainComponent::resized()
@@ -32,6 +32,8 @@ private:
     Sequencer sequencer;
     juce::TextButton playButton;
     juce::Slider bpmSlider;
+    juce::ComboBox patternBox;
+    juce::TextButton bounceButton;
     bool isPlaying = false;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
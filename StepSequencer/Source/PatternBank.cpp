@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    PatternBank.cpp
+    Created: 18 Oct 2026 5:12:26pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "PatternBank.h"
+
+Pattern::Pattern()
+{
+    // Every step starts off, at full velocity and always playing once it is turned on
+    for (auto& track : tracks)
+    {
+        track.steps = 0;
+        std::fill (std::begin (track.velocities), std::end (track.velocities), (juce::uint8) 127);
+        std::fill (std::begin (track.probabilities), std::end (track.probabilities), (juce::uint8) 100);
+    }
+}
+
+PatternBank::PatternBank()
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        snapshots.add (new Snapshot());
+    }
+    published.set (snapshots[0]);
+}
+
+// Editing ==============================================================================
+template <typename Edit>
+void PatternBank::edit (Edit&& change)
+{
+    auto* current = published.get();
+
+    // Neither the published snapshot nor the one the audio thread holds can be written
+    Snapshot* spare = nullptr;
+    for (auto* snapshot : snapshots)
+    {
+        if (snapshot != current && snapshot != inUse.get())
+        {
+            spare = snapshot;
+            break;
+        }
+    }
+    jassert (spare != nullptr);
+
+    *spare = *current;
+    change (*spare);
+    published.set (spare);
+}
+
+void PatternBank::toggleStep (int pattern, int track, int step)
+{
+    setStep (pattern, track, step, ! getPattern (pattern).isOn (track, step));
+}
+
+void PatternBank::setStep (int pattern, int track, int step, bool isOn)
+{
+    jassert (juce::isPositiveAndBelow (track, (int) Pattern::maxTracks) && juce::isPositiveAndBelow (step, (int) Pattern::maxSteps));
+
+    edit ([=] (Snapshot& snapshot)
+    {
+        auto& steps = snapshot.patterns[pattern].tracks[track].steps;
+        auto bit = (juce::uint64) 1 << step;
+        steps = isOn ? (steps | bit) : (steps & ~bit);
+    });
+}
+
+void PatternBank::setVelocity (int pattern, int track, int step, float velocity)
+{
+    edit ([=] (Snapshot& snapshot)
+    {
+        snapshot.patterns[pattern].tracks[track].velocities[step] = (juce::uint8) juce::jlimit (0, 127, juce::roundToInt (velocity * 127.0f));
+    });
+}
+
+void PatternBank::setProbability (int pattern, int track, int step, float probability)
+{
+    edit ([=] (Snapshot& snapshot)
+    {
+        snapshot.patterns[pattern].tracks[track].probabilities[step] = (juce::uint8) juce::jlimit (0, 100, juce::roundToInt (probability * 100.0f));
+    });
+}
+
+void PatternBank::setLength (int pattern, int numSteps)
+{
+    edit ([=] (Snapshot& snapshot)
+    {
+        snapshot.patterns[pattern].numSteps = juce::jlimit (1, (int) Pattern::maxSteps, numSteps);
+    });
+}
+
+void PatternBank::setChain (const juce::Array<int>& patterns)
+{
+    edit ([&patterns] (Snapshot& snapshot)
+    {
+        snapshot.chainLength = juce::jmin (patterns.size(), (int) numPatterns);
+        for (int i = 0; i < snapshot.chainLength; ++i)
+        {
+            snapshot.chain[i] = juce::jlimit (0, numPatterns - 1, patterns[i]);
+        }
+    });
+}
+
+// Playback ==============================================================================
+const PatternBank::Snapshot& PatternBank::acquire()
+{
+    // Mark the snapshot as in use before reading it, and make sure it was still
+    // the published one at that point. Otherwise an edit may already be reusing it.
+    Snapshot* snapshot;
+    do
+    {
+        snapshot = published.get();
+        inUse.set (snapshot);
+    }
+    while (snapshot != published.get());
+
+    return *snapshot;
+}
+
+int PatternBank::startBar (const Snapshot& snapshot)
+{
+    auto queued = queuedPattern.exchange (-1);
+
+    if (queued >= 0)
+    {
+        playing = queued;
+        chainPosition = -1;
+    }
+    else if (snapshot.chainLength > 0)
+    {
+        chainPosition = (chainPosition + 1) % snapshot.chainLength;
+        playing = snapshot.chain[chainPosition];
+    }
+
+    playingPattern.set (playing);
+    return playing;
+}
+
+void PatternBank::reset()
+{
+    chainPosition = -1;
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    PatternBank.h
+    Created: 18 Oct 2026 5:12:26pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// The steps of every track in one pattern, one bit per step, with a velocity
+// and a probability for each step
+struct Pattern
+{
+    static constexpr int maxSteps = 64;
+    static constexpr int maxTracks = 16;
+
+    struct TrackSteps
+    {
+        juce::uint64 steps;
+
+        // 0 to 127, like MIDI velocity
+        juce::uint8 velocities[maxSteps];
+
+        // Percent chance of the step playing
+        juce::uint8 probabilities[maxSteps];
+    };
+
+    Pattern();
+
+    bool isOn (int track, int step) const
+    {
+        return ((tracks[track].steps >> step) & 1) != 0;
+    }
+
+    float getVelocity (int track, int step) const
+    {
+        return tracks[track].velocities[step] / 127.0f;
+    }
+
+    float getProbability (int track, int step) const
+    {
+        return tracks[track].probabilities[step] / 100.0f;
+    }
+
+    TrackSteps tracks[maxTracks];
+    int numSteps = 16;
+};
+
+// A bank of patterns shared between the message thread, which edits it, and
+// the audio thread, which plays it. Every edit is made on a spare copy of the
+// bank and then published with a single atomic pointer swap, so the audio
+// thread never sees a half-made edit and never waits.
+//
+// Switching to another pattern, or moving along a chain of patterns, only
+// happens at the start of a bar.
+class PatternBank
+{
+public:
+    static constexpr int numPatterns = 64;
+
+    struct Snapshot
+    {
+        Pattern patterns[numPatterns];
+
+        // Patterns to play one bar each, in order. Empty means stay on the current one.
+        int chain[numPatterns];
+        int chainLength = 0;
+    };
+
+    PatternBank();
+
+    // Message thread. Each of these publishes a new snapshot.
+    void toggleStep (int pattern, int track, int step);
+    void setStep (int pattern, int track, int step, bool isOn);
+    void setVelocity (int pattern, int track, int step, float velocity);
+    void setProbability (int pattern, int track, int step, float probability);
+    void setLength (int pattern, int numSteps);
+    void setChain (const juce::Array<int>& patterns);
+
+    // Message thread. The latest edits, as the UI should show them.
+    const Pattern& getPattern (int pattern) const
+    {
+        return published.get()->patterns[pattern];
+    }
+
+    // Message thread. Plays pattern from the next bar. A chain picks up from its start afterwards.
+    void queuePattern (int pattern)
+    {
+        queuedPattern.set (juce::jlimit (0, numPatterns - 1, pattern));
+    }
+
+    int getPlayingPattern() const
+    {
+        return playingPattern.get();
+    }
+
+    // Audio thread. Call acquire once at the start of each block and read only
+    // that snapshot until the next block.
+    const Snapshot& acquire();
+
+    // Audio thread. Picks the pattern for the bar that is starting.
+    int startBar (const Snapshot& snapshot);
+
+    // Audio thread. Goes back to the start of the chain.
+    void reset();
+
+private:
+    template <typename Edit>
+    void edit (Edit&& change);
+
+    // Three copies are enough: the published one, the one the audio thread
+    // may still be reading, and a spare to make the next edit in
+    juce::OwnedArray<Snapshot> snapshots;
+    juce::Atomic<Snapshot*> published { nullptr };
+    juce::Atomic<Snapshot*> inUse { nullptr };
+
+    juce::Atomic<int> queuedPattern { -1 };
+    juce::Atomic<int> playingPattern { 0 };
+
+    // Only touched on the audio thread
+    int playing = 0;
+    int chainPosition = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PatternBank)
+};
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    PatternBouncer.cpp
+    Created: 18 Oct 2026 3:12:40pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "PatternBouncer.h"
+#include "Clock.h"
+#include "SampleVoiceMixer.h"
+
+namespace
+{
+    // Plays a pattern into a mixer the same way Sequencer does, for a fixed number of steps
+    class OfflinePlayer : public Clock::Listener
+    {
+    public:
+        OfflinePlayer (const Pattern& pattern, const juce::Array<PatternBouncer::TrackSettings>& kit,
+                       SampleVoiceMixer& mixer, int numSteps)
+            : pattern (pattern), kit (kit), mixer (mixer), numSteps (numSteps)
+        {
+        }
+
+        void tick (int count, int sampleOffset) override
+        {
+            if (isFinished())
+            {
+                return;
+            }
+
+            auto position = stepsPlayed % pattern.numSteps;
+
+            for (auto track = 0; track < juce::jmin (kit.size(), (int) Pattern::maxTracks); ++track)
+            {
+                const auto& settings = kit.getReference (track);
+
+                if (settings.sample != nullptr && pattern.isOn (track, position)
+                    && random.nextFloat() < pattern.getProbability (track, position))
+                {
+                    mixer.triggerAt (sampleOffset, &settings, settings.sample.get(),
+                                     settings.gain * pattern.getVelocity (track, position), settings.pan,
+                                     false, settings.maxPolyphony, settings.chokeGroup);
+                }
+            }
+
+            ++stepsPlayed;
+        }
+
+        void reset() override {}
+
+        bool isFinished() const
+        {
+            return stepsPlayed >= numSteps;
+        }
+
+    private:
+        const Pattern& pattern;
+        const juce::Array<PatternBouncer::TrackSettings>& kit;
+        SampleVoiceMixer& mixer;
+        int numSteps;
+        int stepsPlayed = 0;
+        juce::Random random;
+    };
+}
+
+PatternBouncer::PatternBouncer()
+    : pool (juce::jmax (1, juce::SystemStats::getNumCpus() - 1))
+{
+    writerThread.startThread();
+}
+
+PatternBouncer::~PatternBouncer()
+{
+    pool.removeAllJobs (true, 10000);
+    writerThread.stopThread (2000);
+}
+
+void PatternBouncer::bounce (const juce::Array<Job>& jobs, const juce::Array<TrackSettings>& kit,
+                             double sampleRate, float bpm, bool inParallel,
+                             std::function<void (int numWritten)> onFinished)
+{
+    // No job would ever run to report back, so do it here. Still asynchronously,
+    // so the caller sees the same order of events either way.
+    if (jobs.isEmpty())
+    {
+        if (onFinished != nullptr)
+        {
+            juce::MessageManager::callAsync ([onFinished] { onFinished (0); });
+        }
+        return;
+    }
+
+    // Shared by the render jobs. Whichever finishes last reports back.
+    struct Progress
+    {
+        std::atomic<int> remaining { 0 };
+        std::atomic<int> numWritten { 0 };
+        std::function<void (int)> onFinished;
+    };
+
+    auto progress = std::make_shared<Progress>();
+    progress->onFinished = std::move (onFinished);
+
+    auto renderAll = [this, kit, sampleRate, bpm, progress] (juce::Array<Job> batch)
+    {
+        for (const auto& job : batch)
+        {
+            if (render (job, kit, sampleRate, bpm, writerThread))
+            {
+                ++progress->numWritten;
+            }
+        }
+
+        if (--progress->remaining == 0 && progress->onFinished != nullptr)
+        {
+            juce::MessageManager::callAsync ([progress] { progress->onFinished (progress->numWritten); });
+        }
+    };
+
+    if (inParallel)
+    {
+        progress->remaining = jobs.size();
+
+        for (const auto& job : jobs)
+        {
+            pool.addJob ([renderAll, job] { renderAll (juce::Array<Job> (job)); });
+        }
+    }
+    else
+    {
+        progress->remaining = 1;
+        pool.addJob ([renderAll, jobs] { renderAll (jobs); });
+    }
+}
+
+bool PatternBouncer::render (const Job& job, const juce::Array<TrackSettings>& kit,
+                             double sampleRate, float bpm, juce::TimeSliceThread& writerThread)
+{
+    job.file.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream (job.file.createOutputStream());
+
+    if (stream == nullptr)
+    {
+        return false;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer (format.createWriterFor (stream.get(), sampleRate, 2, 24, {}, 0));
+
+    if (writer == nullptr)
+    {
+        return false;
+    }
+    stream.release();
+
+    // Blocks go through a FIFO to the writer thread. Destroying it flushes what is left.
+    juce::AudioFormatWriter::ThreadedWriter threadedWriter (writer.release(), writerThread, 1 << 16);
+
+    SampleVoiceMixer mixer;
+    OfflinePlayer player (job.pattern, kit, mixer, job.numBars * job.pattern.numSteps);
+
+    Clock clock;
+    clock.setListener (&player);
+    clock.prepare (sampleRate);
+    clock.setBPM (bpm);
+    clock.start();
+
+    // The bars themselves, then up to ten seconds for the last hits to fade
+    auto samplesPerStep = sampleRate * 24.0 / bpm;
+    auto numBarSamples = (juce::int64) std::ceil (samplesPerStep * job.numBars * job.pattern.numSteps);
+    auto maxSamples = numBarSamples + (juce::int64) (sampleRate * 10.0);
+
+    const int blockSize = 512;
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    juce::int64 numRendered = 0;
+
+    while (numRendered < maxSamples)
+    {
+        if (numRendered >= numBarSamples && mixer.getNumActiveVoices() == 0)
+        {
+            break;
+        }
+
+        // Stop exactly at the end of the last bar while steps are still playing
+        auto numSamples = numRendered < numBarSamples ? (int) juce::jmin ((juce::int64) blockSize, numBarSamples - numRendered)
+                                                      : blockSize;
+
+        buffer.clear();
+        clock.advance (numSamples);
+        mixer.getNextAudioBlock (juce::AudioSourceChannelInfo (&buffer, 0, numSamples));
+
+        // The FIFO only fills up if rendering outruns the disk
+        while (! threadedWriter.write (buffer.getArrayOfReadPointers(), numSamples))
+        {
+            juce::Thread::sleep (1);
+        }
+
+        numRendered += numSamples;
+    }
+
+    return true;
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    PatternBouncer.h
+    Created: 18 Oct 2026 3:12:40pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PatternBank.h"
+#include "SampleCache.h"
+
+// Renders patterns to WAV files without an audio device, as fast as the CPU
+// allows. Each render drives its own Clock and SampleVoiceMixer, so bouncing
+// never touches what the device is playing, and finished blocks are handed to
+// a background writer so rendering never waits on the disk.
+class PatternBouncer
+{
+public:
+    // How one track plays, copied from its SampleBuffer when the bounce starts
+    struct TrackSettings
+    {
+        CachedSample::Ptr sample;
+        float gain = 1.0f;
+        float pan = 0.0f;
+        int maxPolyphony = 4;
+        int chokeGroup = 0;
+    };
+
+    struct Job
+    {
+        Pattern pattern;
+        int numBars = 1;
+        juce::File file;
+    };
+
+    PatternBouncer();
+    ~PatternBouncer();
+
+    // Message thread. Renders every job in the background, all at once on
+    // separate threads if inParallel is set, otherwise one after another.
+    // onFinished is called on the message thread with the number of files written.
+    void bounce (const juce::Array<Job>& jobs, const juce::Array<TrackSettings>& kit,
+                 double sampleRate, float bpm, bool inParallel,
+                 std::function<void (int numWritten)> onFinished);
+
+    bool isBouncing() const
+    {
+        return pool.getNumJobs() > 0;
+    }
+
+    // Renders one job on the calling thread, which must not be the audio thread.
+    // The pattern plays numBars times, then the last hits ring out.
+    static bool render (const Job& job, const juce::Array<TrackSettings>& kit,
+                        double sampleRate, float bpm, juce::TimeSliceThread& writerThread);
+
+private:
+    juce::ThreadPool pool;
+    juce::TimeSliceThread writerThread { "Pattern Bounce Writer" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PatternBouncer)
+};
@@ -10,50 +10,107 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "SampleCache.h"
+#include "SampleVoiceMixer.h"
 
+// A sample that plays through the app's SampleVoiceMixer
 class SampleBuffer
 {
 public:
-    SampleBuffer()
-    {
-        // Register the audio formats that come with JUCE
-        formatManager.registerBasicFormats();
-    }
+    SampleBuffer (SampleVoiceMixer& mixer) : mixer (mixer) {}
 
-    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
-    void releaseResources();
-    
-    // Play/Record functions
+    // Play/Record functions. playAt is for the audio thread, and starts the
+    // sample sampleOffset samples into the block about to be rendered.
     void play();
+    void playAt (int sampleOffset, float velocity = 1.0f);
     void stop();
     void record (int numChannels, int numSamples);
     void enableLoop (bool isLooping);
+
+    void setGain (float gain)
+    {
+        this->gain = gain;
+    }
+
+    float getGain() const
+    {
+        return gain;
+    }
+
+    // -1 is hard left, 1 is hard right
+    void setPan (float pan)
+    {
+        this->pan = pan;
+    }
+
+    float getPan() const
+    {
+        return pan;
+    }
+
+    // How many hits of this sample may ring at once before the oldest is faded out
+    void setMaxPolyphony (int maxPolyphony)
+    {
+        this->maxPolyphony = maxPolyphony;
+    }
+
+    int getMaxPolyphony() const
+    {
+        return maxPolyphony;
+    }
+
+    // Buffers sharing a choke group other than 0 cut each other off
+    void setChokeGroup (int chokeGroup)
+    {
+        this->chokeGroup = chokeGroup;
+    }
+
+    int getChokeGroup() const
+    {
+        return chokeGroup;
+    }
+
+    // Hats share a choke group so a closed hat cuts off an open one
+    static int getDefaultChokeGroup (const juce::String& fileName);
     
-    // File managing
-    void loadAudioFileFromAsset (juce::String fileName);
+    // File managing. Loading may run on any thread except the audio thread.
+    // The sample is converted to sampleRate, and the buffer keeps playing the
+    // previous version, or stays silent, until it has finished.
+    void loadAudioFileFromAsset (juce::String fileName, double sampleRate);
 
-    bool getIsPlaying() const
+    bool isLoaded() const
     {
-        return isPlaying;
+        return loadedSample.get() != nullptr;
     }
 
     int getNumSamples() const
     {
-        return fileBuffer.getNumSamples();
+        auto* current = loadedSample.get();
+        return current != nullptr ? current->getNumSamples() : 0;
     }
 
-    juce::AudioBuffer<float> getBuffer()
+    // The decoded audio is shared with every other buffer using the same asset
+    CachedSample::Ptr getSample() const
     {
-        return fileBuffer;
+        return loadedSample.get();
     }
     
 private:
+    static std::unique_ptr<juce::InputStream> openAsset (const juce::String& fileName);
+
+    SampleVoiceMixer& mixer;
+    juce::SharedResourcePointer<SampleCache> cache;
+    CachedSample::Ptr sample;
 
-    juce::AudioFormatManager formatManager;
-    juce::AudioBuffer<float> fileBuffer;
+    // What play() hands to the mixer. The cache keeps older versions alive
+    // until the device stops, so voices still playing them stay valid.
+    juce::Atomic<CachedSample*> loadedSample { nullptr };
+    juce::CriticalSection loadLock;
 
-    int position = 0;
-    bool isPlaying = false;
+    float gain = 1.0f;
+    float pan = 0.0f;
+    int maxPolyphony = 4;
+    int chokeGroup = 0;
     bool isLooping = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleBuffer)
@@ -17,9 +17,10 @@ void Sequencer::createTracks()
     for (int i = 0; i < apkZip.getNumEntries(); ++i)
     {
         auto* entry = apkZip.getEntry (i);
-        if (entry->filename.contains ("assets/Sounds/"))
+        // A pattern has room for Pattern::maxTracks tracks
+        if (entry->filename.contains ("assets/Sounds/") && tracks.size() < Pattern::maxTracks)
         {
-            tracks.add (new Track (entry->filename, getStep()));
+            tracks.add (new Track (entry->filename, mixer));
         }
     }
 #elif JUCE_IOS
@@ -27,47 +28,131 @@ void Sequencer::createTracks()
                               .getParentDirectory().getChildFile ("Assets");
     auto soundDir = assetsDir.getChildFile ("Sounds");
     auto files = soundDir.findChildFiles (juce::File::TypesOfFileToFind::findFiles, false, "*.wav");
-    for (int i = 0; i < files.size(); ++i)
+    for (int i = 0; i < juce::jmin (files.size(), (int) Pattern::maxTracks); ++i)
     {
-        tracks.add (new Track (files[i].getFullPathName(), getStep()));
+        tracks.add (new Track (files[i].getFullPathName(), mixer));
     }
 #endif
+
+    grid.setNumTracks (tracks.size());
 }
 
-void Sequencer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+void Sequencer::prepareToPlay (double sampleRate)
 {
-    for (auto track = 0; track < tracks.size(); ++track)
+    prepare (sampleRate);
+
+    // Load the kit at the device rate, and again whenever that rate changes.
+    // Decoding and converting happen in the background, and each track becomes
+    // playable as soon as it is done.
+    if (sampleRate == kitSampleRate)
+    {
+        return;
+    }
+    kitSampleRate = sampleRate;
+
+    juce::Component::SafePointer<Sequencer> safeThis (this);
+    for (auto index = 0; index < tracks.size(); ++index)
     {
-        tracks[track]->getNextAudioBlock (bufferToFill);
+        auto* track = tracks[index];
+        kitLoader.add ([track, sampleRate] { track->loadSample (sampleRate); },
+                       [safeThis, index]
+                       {
+                           if (safeThis != nullptr)
+                           {
+                               safeThis->grid.setTrackReady (index, safeThis->tracks[index]->isLoaded());
+                           }
+                       });
     }
 }
 
+void Sequencer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // Trigger this block's steps at their exact samples, then mix
+    snapshot = &patternBank.acquire();
+    advance (bufferToFill.numSamples);
+    mixer.getNextAudioBlock (bufferToFill);
+}
+
 void Sequencer::releaseResources()
 {
     stop();
-    for (auto track = 0; track < tracks.size(); ++track)
-    {
-        tracks[track]->releaseResources();
-    }
+
+    // Nothing is playing now, so samples at an old rate can go
+    mixer.releaseResources();
+    sampleCache->releaseUnused();
 }
 
-void Sequencer::tick (int count)
+void Sequencer::tick (int count, int sampleOffset)
 {
+    // A new bar is where pattern switches and chains take effect
+    if (position == 0)
+    {
+        playingPattern = patternBank.startBar (*snapshot);
+    }
+
+    const auto& pattern = snapshot->patterns[playingPattern];
+    position = juce::jmin (position, pattern.numSteps - 1);
+
+    grid.setPlayhead (position);
+
     for (auto track = 0; track < tracks.size(); ++track)
     {
-        tracks[track]->play (count);
+        if (pattern.isOn (track, position) && random.nextFloat() < pattern.getProbability (track, position))
+        {
+            tracks[track]->play (sampleOffset, pattern.getVelocity (track, position));
+        }
     }
+
+    position = (position + 1) % pattern.numSteps;
 }
 
 void Sequencer::reset()
 {
-    
+    position = 0;
+    patternBank.reset();
+    grid.setPlayhead (-1);
+}
+
+void Sequencer::selectPattern (int pattern)
+{
+    grid.setEditedPattern (pattern);
+    patternBank.queuePattern (pattern);
 }
 
-void Sequencer::paint (juce::Graphics& g)
+void Sequencer::bounce (const juce::Array<int>& patterns, int numBars, bool inParallel,
+                        std::function<void (int numWritten)> onFinished)
 {
-    for (auto track = 0; track < tracks.size(); ++track) {
-        addAndMakeVisible (tracks[track]);
-        tracks[track]->setBounds (5, 5 + (getHeight() / tracks.size()) * track, getWidth() - 10, getHeight() / tracks.size() - 10);
+    // Nothing to render with until the kit has loaded at a known rate
+    if (kitSampleRate <= 0.0)
+    {
+        if (onFinished != nullptr)
+        {
+            onFinished (0);
+        }
+        return;
     }
+
+    // Copy what the renders need, so editing and playing carry on while they run
+    juce::Array<PatternBouncer::TrackSettings> kit;
+    for (auto* track : tracks)
+    {
+        const auto& buffer = track->getSampleBuffer();
+        kit.add ({ buffer.getSample(), buffer.getGain(), buffer.getPan(),
+                   buffer.getMaxPolyphony(), buffer.getChokeGroup() });
+    }
+
+    auto folder = juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory);
+    juce::Array<PatternBouncer::Job> jobs;
+    for (auto pattern : patterns)
+    {
+        jobs.add ({ patternBank.getPattern (pattern), numBars,
+                    folder.getNonexistentChildFile ("StepSequencer Pattern " + juce::String (pattern + 1), ".wav") });
+    }
+
+    bouncer.bounce (jobs, kit, kitSampleRate, getBPM(), inParallel, std::move (onFinished));
+}
+
+void Sequencer::resized()
+{
+    grid.setBounds (getLocalBounds());
 }
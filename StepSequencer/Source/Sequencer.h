@@ -12,6 +12,10 @@
 #include <JuceHeader.h>
 #include "Clock.h"
 #include "Track.h"
+#include "KitLoader.h"
+#include "PatternBank.h"
+#include "PatternBouncer.h"
+#include "StepGrid.h"
 
 class Sequencer : public juce::Component, public Clock, private Clock::Listener
 {
@@ -19,16 +23,49 @@ public:
     Sequencer()
     {
         setListener (this);
+        addAndMakeVisible (grid);
     }
     void createTracks();
-    void paint (juce::Graphics& g) override;
-    void tick (int count) override;
+    void resized() override;
+    void tick (int count, int sampleOffset) override;
     void reset() override;
+    void prepareToPlay (double sampleRate);
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
     void releaseResources();
+
+    // Message thread. Shows pattern for editing and plays it from the next bar.
+    void selectPattern (int pattern);
+
+    // Message thread. Renders each pattern numBars times to its own WAV file in
+    // the user's application data folder, without waiting for the device.
+    void bounce (const juce::Array<int>& patterns, int numBars, bool inParallel,
+                 std::function<void (int numWritten)> onFinished);
+
+    PatternBank& getPatternBank()
+    {
+        return patternBank;
+    }
     
 private:
+    // Plays every track, so it has to outlive them
+    SampleVoiceMixer mixer;
+    PatternBank patternBank;
     juce::OwnedArray<Track> tracks;
+    StepGrid grid { patternBank };
+
+    // Only touched on the audio thread
+    const PatternBank::Snapshot* snapshot = nullptr;
+    int playingPattern = 0;
+    int position = 0;
+    juce::Random random;
+
+    // Declared after tracks so its jobs are finished before the tracks are deleted
+    KitLoader kitLoader;
+    juce::SharedResourcePointer<SampleCache> sampleCache;
+    double kitSampleRate = 0.0;
+
+    // Holds references to the kit's samples while it renders
+    PatternBouncer bouncer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Sequencer)
 };
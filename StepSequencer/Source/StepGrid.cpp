@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    StepGrid.cpp
+    Created: 18 Oct 2026 5:26:03pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "StepGrid.h"
+
+StepGrid::StepGrid (PatternBank& bank)
+    : bank (bank)
+{
+    // Every cell is filled, so nothing behind the grid has to be repainted with it
+    setOpaque (true);
+    startTimerHz (60);
+}
+
+void StepGrid::setNumTracks (int numTracks)
+{
+    this->numTracks = juce::jmin (numTracks, (int) Pattern::maxTracks);
+    repaint();
+}
+
+void StepGrid::setTrackReady (int track, bool isReady)
+{
+    auto bit = (juce::uint32) 1 << track;
+    readyTracks = isReady ? (readyTracks | bit) : (readyTracks & ~bit);
+    repaint (getCellBounds (track, 0).getUnion (getCellBounds (track, drawnNumSteps - 1)));
+}
+
+void StepGrid::setEditedPattern (int pattern)
+{
+    editedPattern = pattern;
+
+    // Only the cells that differ from the previous pattern are repainted
+    timerCallback();
+}
+
+void StepGrid::timerCallback()
+{
+    const auto& pattern = bank.getPattern (editedPattern);
+
+    // A new length moves every cell
+    if (pattern.numSteps != drawnNumSteps)
+    {
+        drawnNumSteps = pattern.numSteps;
+        for (auto track = 0; track < numTracks; ++track)
+        {
+            drawnSteps[track] = pattern.tracks[track].steps;
+        }
+        drawnPlayhead = playhead.get();
+        repaint();
+        return;
+    }
+
+    for (auto track = 0; track < numTracks; ++track)
+    {
+        auto changed = pattern.tracks[track].steps ^ drawnSteps[track];
+        if (changed == 0)
+        {
+            continue;
+        }
+
+        drawnSteps[track] = pattern.tracks[track].steps;
+        for (auto step = 0; step < drawnNumSteps; ++step)
+        {
+            if (((changed >> step) & 1) != 0)
+            {
+                repaint (getCellBounds (track, step));
+            }
+        }
+    }
+
+    auto current = playhead.get();
+    if (current != drawnPlayhead)
+    {
+        repaintColumn (drawnPlayhead);
+        drawnPlayhead = current;
+        repaintColumn (current);
+    }
+}
+
+void StepGrid::repaintColumn (int step)
+{
+    if (step >= 0 && step < drawnNumSteps && numTracks > 0)
+    {
+        repaint (getCellBounds (0, step).getUnion (getCellBounds (numTracks - 1, step)));
+    }
+}
+
+juce::Rectangle<int> StepGrid::getCellBounds (int track, int step) const
+{
+    auto cellWidth = getWidth() / juce::jmax (1, drawnNumSteps);
+    auto cellHeight = getHeight() / juce::jmax (1, numTracks);
+    return juce::Rectangle<int> (step * cellWidth, track * cellHeight, cellWidth, cellHeight).reduced (5);
+}
+
+void StepGrid::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    // Only the cells inside the area being repainted are drawn
+    auto clip = g.getClipBounds();
+
+    for (auto track = 0; track < numTracks; ++track)
+    {
+        auto isReady = ((readyTracks >> track) & 1) != 0;
+
+        for (auto step = 0; step < drawnNumSteps; ++step)
+        {
+            auto cell = getCellBounds (track, step);
+            if (! clip.intersects (cell))
+            {
+                continue;
+            }
+
+            auto colour = step == drawnPlayhead ? juce::Colours::yellow
+                        : ((drawnSteps[track] >> step) & 1) != 0 ? juce::Colours::red
+                        : juce::Colours::green;
+
+            g.setColour (isReady ? colour : colour.withAlpha (0.3f));
+            g.fillRect (cell);
+        }
+    }
+}
+
+void StepGrid::mouseDown (const juce::MouseEvent& event)
+{
+    for (auto track = 0; track < numTracks; ++track)
+    {
+        for (auto step = 0; step < drawnNumSteps; ++step)
+        {
+            if (getCellBounds (track, step).contains (event.getPosition()))
+            {
+                if (((readyTracks >> track) & 1) != 0)
+                {
+                    bank.toggleStep (editedPattern, track, step);
+                    timerCallback();
+                }
+                return;
+            }
+        }
+    }
+}
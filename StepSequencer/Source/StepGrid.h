@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    StepGrid.h
+    Created: 18 Oct 2026 5:26:03pm
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "PatternBank.h"
+
+// Draws every step of the edited pattern in one component, one row per track.
+// It remembers what each cell showed when it was last painted, and a timer
+// repaints only the cells whose step has changed and the two columns the
+// playhead has left and entered.
+class StepGrid : public juce::Component, private juce::Timer
+{
+public:
+    explicit StepGrid (PatternBank& bank);
+
+    void setNumTracks (int numTracks);
+
+    // Rows stay dimmed and ignore clicks until their track's sample is loaded
+    void setTrackReady (int track, bool isReady);
+
+    // The pattern the grid shows and edits
+    void setEditedPattern (int pattern);
+
+    // Audio thread. The step being played, or -1 to hide the playhead.
+    void setPlayhead (int step)
+    {
+        playhead.set (step);
+    }
+
+    void paint (juce::Graphics& g) override;
+    void mouseDown (const juce::MouseEvent& event) override;
+
+private:
+    void timerCallback() override;
+    void repaintColumn (int step);
+    juce::Rectangle<int> getCellBounds (int track, int step) const;
+
+    PatternBank& bank;
+    juce::Atomic<int> playhead { -1 };
+
+    int numTracks = 0;
+    int editedPattern = 0;
+    juce::uint32 readyTracks = 0;
+
+    // What the cells showed the last time they were repainted
+    juce::uint64 drawnSteps[Pattern::maxTracks] = {};
+    int drawnNumSteps = 0;
+    int drawnPlayhead = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StepGrid)
+};
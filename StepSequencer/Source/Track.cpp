@@ -10,61 +10,18 @@
 
 #include "Track.h"
 
-Track::Track (juce::String fileName, int numBeats): numBeats (numBeats)
+Track::Track (juce::String fileName, SampleVoiceMixer& mixer)
+    : fileName (fileName), sampleBuffer (mixer)
 {
-    // Load audio file
-    sampleBuffer.loadAudioFileFromAsset (fileName);
-    
-    // Create buttons
-    for(auto beat = 0; beat < numBeats; ++beat)
-    {
-        buttons.add (new juce::ShapeButton ("", juce::Colours::green,  juce::Colours::green,  juce::Colours::grey));
-        buttons.getLast()->addListener (this);
-        beats.add (new bool (false));
-    }
+    sampleBuffer.setChokeGroup (SampleBuffer::getDefaultChokeGroup (fileName));
 }
 
-void Track::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+void Track::loadSample (double sampleRate)
 {
-    sampleBuffer.getNextAudioBlock (bufferToFill);
+    sampleBuffer.loadAudioFileFromAsset (fileName, sampleRate);
 }
 
-void Track::releaseResources()
+void Track::play (int sampleOffset, float velocity)
 {
-    sampleBuffer.releaseResources();
-}
-
-void Track::play (int beat)
-{
-    if (*beats[beat])
-    {
-        sampleBuffer.play();
-    }
-    curBeat = beat;
-}
-
-void Track::paint (juce::Graphics& g)
-{
-    for (int beat = 0 ; beat < beats.size(); ++beat)
-    {
-        addAndMakeVisible (buttons[beat]);
-        juce::Path rectPath;
-        rectPath.addRectangle (0, 0, 100, 100);
-        buttons[beat]->setShape (rectPath, true, false, false);
-        if (*beats[beat]){
-            buttons[beat]->setColours (juce::Colours::red,  juce::Colours::red,  juce::Colours::grey);
-        }
-        else {
-            buttons[beat]->setColours (juce::Colours::green,  juce::Colours::green,  juce::Colours::grey);
-        }
-        buttons[beat]->setBounds (5 + (getWidth() / numBeats) * beat, 0, getWidth() / numBeats - 10, getHeight());
-    }
-    
-    buttons[curBeat]->setColours (juce::Colours::yellow,  juce::Colours::yellow,  juce::Colours::grey);
-}
-
-void Track::buttonClicked (juce::Button *button)
-{
-    auto index = buttons.indexOf ((juce::ShapeButton*) button);
-    *beats[index] = !*beats[index];
+    sampleBuffer.playAt (sampleOffset, velocity);
 }
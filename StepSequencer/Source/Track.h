@@ -12,26 +12,31 @@
 #include <JuceHeader.h>
 #include "SampleBuffer.h"
 
-class Track: public juce::Component, private juce::Button::Listener
+// One sound of the kit. Its steps live in the PatternBank and are drawn by the StepGrid.
+class Track
 {
 public:
-    Track (juce::String fileName, int numBeats);
-    void buttonClicked (juce::Button *button) override;
+    Track (juce::String fileName, SampleVoiceMixer& mixer);
     
-    void paint(juce::Graphics& g) override;
-    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
-    void releaseResources();
-    
-    void play (int beat);
+    // Audio thread. Plays the sample sampleOffset samples into the block.
+    void play (int sampleOffset, float velocity);
+
+    // Decodes the sample and converts it to sampleRate. Runs on a KitLoader thread.
+    void loadSample (double sampleRate);
+
+    bool isLoaded() const
+    {
+        return sampleBuffer.isLoaded();
+    }
+
+    const SampleBuffer& getSampleBuffer() const
+    {
+        return sampleBuffer;
+    }
     
 private:
+    juce::String fileName;
     SampleBuffer sampleBuffer;
-    
-    int numBeats;
-    int curBeat = 0;
-    juce::OwnedArray<bool> beats;
-    juce::OwnedArray<juce::ShapeButton> buttons;
-    bool isPlaying = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Track)
 };
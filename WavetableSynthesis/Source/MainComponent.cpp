@@ -36,8 +36,6 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     spec.numChannels = 2;
     processorChain.prepare (spec);
 
-    generateSine();
-
     processorChain.get<oscIndex>().setFrequency (440, true);
     processorChain.get<gainIndex>().setGainLinear (0.5f);
     
@@ -110,60 +108,16 @@ void MainComponent::resized()
     // update their positions.
 }
 
-void MainComponent::generateSine()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-    {
-        return std::sin (x);
-    }, 128);
-}
-
-void MainComponent::generateSawtooth()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-    {
-        return juce::jmap (x,
-                           float (-juce::MathConstants<float>::pi),
-                           float (juce::MathConstants<float>::pi),
-                           float (-1),
-                           float (1));
-    }, 2);
-}
-
-void MainComponent::generateSquare()
-{
-    auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-    {
-        auto val = std::sin (x);
-        return (0.0f < val) - (val < 0.0f);
-    }, 128);
-}
-
-void MainComponent::generateTriangle()
+void MainComponent::buttonClicked (juce::Button* button)
 {
     auto& osc = processorChain.template get<oscIndex>();
-    osc.initialise ([] (float x)
-    {
-        auto val = juce::jmap (x,
-                               float (-juce::MathConstants<float>::pi),
-                               float (juce::MathConstants<float>::pi),
-                               float (0),
-                               float (1));
-        return 2.0f * std::fabs (2.0f * (val - std::floor (val + 0.5f))) - 1.0f;
-    }, 128);
-}
 
-void MainComponent::buttonClicked (juce::Button* button)
-{
     if (button == &sineButton)
-        generateSine();
+        osc.setWaveform (Wavetable::Waveform::sine);
     else if (button == &sawtoothButton)
-        generateSawtooth();
+        osc.setWaveform (Wavetable::Waveform::sawtooth);
     else if (button == &squareButton)
-        generateSquare();
+        osc.setWaveform (Wavetable::Waveform::square);
     else
-        generateTriangle();
+        osc.setWaveform (Wavetable::Waveform::triangle);
 }
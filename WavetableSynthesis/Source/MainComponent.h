@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "WavetableOscillator.h"
 
 //==============================================================================
 /*
@@ -26,18 +27,13 @@ public:
     
 private:
     //==============================================================================
-    juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::Gain<float>> processorChain;
+    juce::dsp::ProcessorChain<WavetableOscillator, juce::dsp::Gain<float>> processorChain;
     enum
     {
         oscIndex,
         gainIndex
     };
 
-    void generateSine();
-    void generateSawtooth();
-    void generateSquare();
-    void generateTriangle();
-    
     juce::TextButton sineButton;
     juce::TextButton sawtoothButton;
     juce::TextButton squareButton;
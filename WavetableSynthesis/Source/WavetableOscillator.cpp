@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    WavetableOscillator.cpp
+    Created: 17 Oct 2026 10:40:03am
+    Author:  Akito van Troyer
+
+  ==============================================================================
+*/
+
+#include "WavetableOscillator.h"
+
+void WavetableOscillator::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // Every waveform is built here, once per device setup, so switching later never allocates
+    if (bank == &ownBank)
+    {
+        ownBank.build (sampleRate);
+    }
+
+    // 10ms crossfade when the waveform changes
+    fadeLength = juce::jmax (1, juce::roundToInt (sampleRate * 0.01));
+
+    currentWaveform = targetWaveform.get();
+    current = &bank->get (currentWaveform);
+    previous = current;
+
+    frequency.reset (sampleRate, 0.05);
+    reset();
+}
+
+void WavetableOscillator::reset() noexcept
+{
+    phase = 0.0f;
+    fadeSamplesRemaining = 0;
+    frequency.setCurrentAndTargetValue (frequency.getTargetValue());
+    updateIncrement (frequency.getTargetValue());
+}
+
+void WavetableOscillator::setFrequency (float newFrequency, bool force) noexcept
+{
+    if (force)
+    {
+        frequency.setCurrentAndTargetValue (newFrequency);
+        updateIncrement (newFrequency);
+        return;
+    }
+
+    frequency.setTargetValue (newFrequency);
+}